@@ -158,6 +158,10 @@ static NSDictionary *sideButtonActions;
         /// Need to manually initConfig because it is shared with Helper, and helper uses `load_Manual`
         ///     Edit: What?? That doesn't make sense to me.
         [Config load_Manual];
+        
+        /// Ask helper whether it's active
+        ///     In the background, so the UI doesn't have to wait for the helper's reply when it first calls `helperIsActive`
+        [HelperServices probeHelperStateInBackground];
     }
     
 }
@@ -298,7 +302,11 @@ static NSDictionary *sideButtonActions;
 }
 - (NSApplicationTerminateReply)applicationShouldTerminate:(NSApplication *)sender {
     DDLogInfo(@"Mac Mouse Fix should terminate");
-
+    
+    /// Write config and secureStorage
+    ///     `commitConfig()` and `SecureStorage.set()` write after a delay
+    [Config.shared flushPendingWrite];
+    [SecureStorage flushPendingWrite];
 
     return NSTerminateNow;
 }
@@ -16,6 +16,7 @@
 #import "MathObjC.h"
 #import "AnimatorDeclarations.h"
 #import "SharedUtility.h"
+#import "MFAtomic.h"
 #import "PolynomialRegression.h"
 #import "VectorSubPixelator.h"
 #import "SubPixelator.h"
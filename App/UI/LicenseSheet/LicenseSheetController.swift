@@ -62,6 +62,7 @@ import Cocoa
             
             /// Delete key
             SecureStorage.delete("License.key")
+            License.invalidateCache()
             
             /// Close sheet
             LicenseSheetController.remove()
@@ -105,6 +106,7 @@ import Cocoa
                     /// Store new licenseKey
                     if success && licenseReason == kMFLicenseReasonValidLicense {
                         SecureStorage.set("License.key", value: key)
+                        License.invalidateCache()
                     }
                     
                     /// Dispatch to main because UI stuff needs to be controlled by main
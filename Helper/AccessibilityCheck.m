@@ -30,21 +30,25 @@
 @implementation AccessibilityCheck
 
 /// Handle Unix signals
+///     We don't do this in a real signal handler (`sigaction()`), because almost nothing we need to do here is async-signal-safe - ObjC messaging, locks, file IO, keychain access. If the signal arrives while one of our threads holds a lock that we need here, we'd deadlock.
+///     Instead, we ignore SIGTERM's default action and watch for it with a dispatch source. That runs `handleSIGTERM()` on the main queue like any other block, so it can safely do all this.
 
-static void signal_handler(int signal_number, siginfo_t *signal_info, void *context) {
+static dispatch_source_t _sigtermSource = nil;
+
+static void handleSIGTERM(void) {
     
-    if (signal_number == SIGTERM) {
-        
-        /// Deconfigure
-        [DeviceManager deconfigureDevices];
-        
-        /// Terminate app
-        ///     I think `NSApplicationMain(argc, argv)` (found in main.m) sets up its own SIGTERM handler which we're overriding here. So we need to manually terminate the app.
-        ///     If this leads to further problems around termination, consider simply sending a `willTerminate` message from the Main App before terminating the Helper.
-        [NSApp terminate:nil];
-    } else {
-        NSLog(@"SIGTERM handler caught weird signal: %d", signal_number); /// Can't use CocoaLumberjack here since it might not be set up, yet (I think)
-    }
+    /// Deconfigure
+    [DeviceManager deconfigureDevices];
+    
+    /// Write config and secureStorage
+    ///     `commitConfig()` and `SecureStorage.set()` write after a delay
+    [Config.shared flushPendingWrite];
+    [SecureStorage flushPendingWrite];
+    
+    /// Terminate app
+    ///     Since we ignore SIGTERM, nothing else terminates the app for us.
+    ///     If this leads to further problems around termination, consider simply sending a `willTerminate` message from the Main App before terminating the Helper.
+    [NSApp terminate:nil];
 }
 
 /// Load
@@ -120,15 +124,12 @@ static void signal_handler(int signal_number, siginfo_t *signal_info, void *cont
     
     /// Setup termination handler
     
-    struct sigaction action = {
-        .sa_flags = SA_SIGINFO,
-        .sa_mask = 0,
-        .sa_sigaction = signal_handler,
-    };
-    int rt = sigaction(SIGTERM, &action, NULL);
-    if (rt < 0) {
-        NSLog(@"Accessibility Check - Error setting up sigterm handler: %d", rt); /// Can't use CocoaLumberjack here, since it's not set up, yet
-    }
+    signal(SIGTERM, SIG_IGN); /// Otherwise, the default action terminates us right away. Dispatch sources still see ignored signals.
+    _sigtermSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_SIGNAL, SIGTERM, 0, dispatch_get_main_queue());
+    dispatch_source_set_event_handler(_sigtermSource, ^{
+        handleSIGTERM();
+    });
+    dispatch_resume(_sigtermSource);
     
     /// Set up CocoaLumberjack
     [SharedUtility setupBasicCocoaLumberjackLogging];
@@ -232,7 +233,8 @@ static void signal_handler(int signal_number, siginfo_t *signal_info, void *cont
         
         NSDictionary *payload = @{
             @"bundleVersion": @(Locator.bundleVersion),
-            @"mainAppURL": Locator.mainAppBundle.bundleURL
+            @"mainAppURL": Locator.mainAppBundle.bundleURL,
+            @"pid": @(NSProcessInfo.processInfo.processIdentifier),
         };
         [MFMessagePort sendMessage:@"helperEnabled" withPayload:payload waitForReply:NO];
         
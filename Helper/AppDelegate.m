@@ -22,7 +22,7 @@
 
 - (void)applicationWillTerminate:(NSNotification *)notification {
     /// This doesn't seem to get called when the Helper is terminated through launchd.
-    /// Instead use `signal_handler` in `AccessibiltyCheck` to catch SIGTERM.
+    /// Instead use `handleSIGTERM` in `AccessibiltyCheck` to catch SIGTERM.
     
 }
 
@@ -12,6 +12,22 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// Fixed-capacity, ordered stack of the buttons that are currently held as modifiers. Ordered by press time, oldest first.
+///     See ButtonModifiers.m for more info.
+
+#define kMFButtonModifierStackCapacity 8
+#define kMFButtonModifierSignatureInexact 0xFFFFFFFFFFFFFFFFULL
+
+typedef struct {
+    uint8_t count;
+    uint8_t buttons[kMFButtonModifierStackCapacity];
+    uint8_t clickLevels[kMFButtonModifierStackCapacity];
+    uint64_t signature;     /// All entries packed into 64 bits. Equal signatures mean equal stacks - unless it's `kMFButtonModifierSignatureInexact`. Empty stack has signature 0.
+} MFButtonModifierStack;
+
+/// Returns the latest published button modifiers. Lock-free and allocation-free, so it can be called from any thread, including other eventTap threads.
+MFButtonModifierStack MFButtonModifiersRead(void);
+
 @interface ButtonModifiers : NSObject
 
 - (void)updateWithButton:(MFMouseButtonNumber)button clickLevel:(NSInteger)clickLevel downNotUp:(BOOL)mouseDown;
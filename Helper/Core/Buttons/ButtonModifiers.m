@@ -10,10 +10,12 @@
 #import "ButtonModifiers.h"
 #import "SharedUtility.h"
 #import "Modifiers.h"
+#import "MFSharedStatus.h"
+#import <stdatomic.h>
 
 @implementation ButtonModifiers {
     
-    ButtonModifierState _state;
+    MFButtonModifierStack _stack;
 }
 
 /// Replacement for `ButtonModifiers.swift` because Swift made things very slow
@@ -23,12 +25,143 @@
 ///     This should only be used by Buttons.swift. Use buttons.swfits dispatchQueue to protect resources.
 /// Optimization:
 ///     Switft does some weird bridging when when we call `state.add(NSDictionary(dictionaryLiteral:)`, that should be much faster in ObjC
+///
+/// On the stack & publishing:
+/// - We used to keep the state as an NSMutableArray of NSDictionaries and edit it in place. That meant allocating on every button press and also that the array which `Modifiers` stored could be mutated while another thread looked at it.
+/// - Now the state is an `MFButtonModifierStack` - a plain C struct with space for `kMFButtonModifierStackCapacity` buttons. Pushing and removing doesn't allocate.
+/// - After every change, we publish a copy of the stack with seqlock semantics. Readers on other threads (e.g. ScrollModifiers on the scroll eventTap thread) can use `MFButtonModifiersRead()` to get a consistent copy without taking a lock. Publishing is only done from the Buttons queue, so there's only ever one writer, which is what a seqlock needs.
+/// - The published stack and its sequence number live together in one cache line.
+/// - `Modifiers` still gets an NSArray of NSDictionaries, since `Remap` uses the modifiers dict as a cache key and `RemapSwizzler` compares against the preconditions in the remaps. But we only build it when the state actually changed.
+
+#pragma mark - Publishing
+
+static struct {
+    _Atomic(uint32_t) sequence; /// Odd while a write is in progress
+    MFButtonModifierStack stack;
+} __attribute__((aligned(64))) _published;
+
+static void publish(const MFButtonModifierStack *stack) {
+    
+    /// Only call from the Buttons queue (single writer)
+    
+    uint32_t sequence = atomic_load_explicit(&_published.sequence, memory_order_relaxed);
+    atomic_store_explicit(&_published.sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    
+    _published.stack = *stack;
+    
+    atomic_store_explicit(&_published.sequence, sequence + 2, memory_order_release);
+}
+
+MFButtonModifierStack MFButtonModifiersRead(void) {
+    
+    /// Retry until we get a copy that wasn't written to while we were reading it. Writes are very rare and very short, so this almost never loops.
+    
+    MFButtonModifierStack result;
+    while (true) {
+        uint32_t sequenceBefore = atomic_load_explicit(&_published.sequence, memory_order_acquire);
+        if (sequenceBefore & 1) continue;
+        
+        result = _published.stack;
+        
+        atomic_thread_fence(memory_order_acquire);
+        uint32_t sequenceAfter = atomic_load_explicit(&_published.sequence, memory_order_relaxed);
+        if (sequenceBefore == sequenceAfter) return result;
+    }
+}
+
+#pragma mark - Stack
+
+static void updateSignature(MFButtonModifierStack *stack) {
+    
+    /// Packs the entries 16 bits each, (button << 8 | clickLevel), first entry in the lowest bits.
+    ///     Buttons and clickLevels are never 0, so an empty slot can't be confused with an entry. That makes this exact for up to 4 entries.
+    
+    if (stack->count > 4) {
+        stack->signature = kMFButtonModifierSignatureInexact;
+        return;
+    }
+    uint64_t signature = 0;
+    for (int i = 0; i < stack->count; i++) {
+        signature |= ((uint64_t)stack->buttons[i] << 8 | stack->clickLevels[i]) << (16 * i);
+    }
+    stack->signature = signature;
+}
+
+static BOOL push(MFButtonModifierStack *stack, MFMouseButtonNumber button, NSInteger clickLevel) {
+    
+    if (stack->count >= kMFButtonModifierStackCapacity) {
+        DDLogWarn(@"buttonModifiers - Can't hold more than %d button modifiers. Ignoring button %d", kMFButtonModifierStackCapacity, button);
+        return NO;
+    }
+    
+    stack->buttons[stack->count] = (uint8_t)MIN(button, UINT8_MAX); /// Buttons go up to `kMFMaxButtonNumber`
+    stack->clickLevels[stack->count] = (uint8_t)MIN(MAX(clickLevel, 0), UINT8_MAX);
+    stack->count += 1;
+    updateSignature(stack);
+    return YES;
+}
+
+static BOOL removeStateForButton(MFButtonModifierStack *stack, MFMouseButtonNumber button) {
+    
+    /// Returns YES if it did remove an entry from the state
+    
+    for (int i = 0; i < stack->count; i++) {
+        
+        if (stack->buttons[i] == button) {
+            
+            /// Shift the following entries down to keep the order
+            for (int j = i; j < stack->count - 1; j++) {
+                stack->buttons[j] = stack->buttons[j+1];
+                stack->clickLevels[j] = stack->clickLevels[j+1];
+            }
+            stack->count -= 1;
+            stack->buttons[stack->count] = 0;
+            stack->clickLevels[stack->count] = 0;
+            updateSignature(stack);
+            return YES;
+        }
+    }
+    
+    return NO;
+}
+
+static ButtonModifierState modifierStateFromStack(const MFButtonModifierStack *stack) {
+    
+    /// Convert to the format that `Modifiers` and the remaps use
+    
+    ButtonModifierState result = [NSMutableArray arrayWithCapacity:stack->count];
+    for (int i = 0; i < stack->count; i++) {
+        [result addObject:@{
+            kMFButtonModificationPreconditionKeyButtonNumber: @(stack->buttons[i]),
+            kMFButtonModificationPreconditionKeyClickLevel: @(stack->clickLevels[i]),
+        }];
+    }
+    return result;
+}
+
+/// Debug helper
+
+static NSString *stateDescription(const MFButtonModifierStack *stack) {
+    
+    NSMutableString *result = [NSMutableString string];
+    
+    for (int i = 0; i < stack->count; i++) {
+        if (i != 0) [result appendString:@" "];
+        [result appendString:stringf(@"(%d, %d)", stack->buttons[i], stack->clickLevels[i])];
+    }
+    
+    return result;
+}
+
+
+#pragma mark - Interface
 
 - (instancetype)init {
     
     self = [super init];
     if (self) {
-        _state = [NSMutableArray array];
+        memset(&_stack, 0, sizeof(_stack));
     }
     return self;
 }
@@ -38,28 +171,13 @@
     BOOL didChange = NO;
     
     if (mouseDown) {
-        
-        [_state addObject:@{
-            kMFButtonModificationPreconditionKeyButtonNumber: @(button),
-            kMFButtonModificationPreconditionKeyClickLevel: @(clickLevel),
-        }];
-        didChange = YES;
-        
+        didChange = push(&_stack, button, clickLevel);
     } else {
-        didChange = removeStateForButton(_state, button);
+        didChange = removeStateForButton(&_stack, button);
     }
     
     if (didChange) {
-        
-        /// Debug
-        if (runningPreRelease()) {
-            NSString *description = stateDescription(_state);
-            DDLogDebug(@"buttonModifiers - update - toState: %@", description);
-        }
-        
-        /// Notify
-        ///     Do we need to check if the buttonMods actually changed?
-        [Modifiers buttonModsChangedTo:_state];
+        [self handleStateChange];
     }
 }
 
@@ -71,62 +189,36 @@
     // -> TODO: Try to do this when we implement SwitchMaster. Then turn this off if successful.
     /// Edit: I do think that killing a button as a modifier after it has directly triggered an action is desirable, now.
     
-    /// Copy old state
-    
     /// Update state
-    BOOL didRemove = removeStateForButton(_state, button);
+    BOOL didRemove = removeStateForButton(&_stack, button);
     
     if (didRemove) {
-        
-        /// Debug
-        if (runningPreRelease()) {
-            NSString *description = stateDescription(_state);
-            DDLogDebug(@"buttonModifiers - update - toState: %@", description);
-        }
-        
-        /// Notify
-        [Modifiers buttonModsChangedTo:_state];
+        [self handleStateChange];
     }
 }
 
-/// Helper
-
-static BOOL removeStateForButton(ButtonModifierState state, MFMouseButtonNumber button) {
-    
-    /// Returns YES if it did remove an entry from the state
+- (void)handleStateChange {
     
-    for (int i = 0; i < state.count; i++) {
-        
-        NSDictionary *buttonState = state[i];
-        NSNumber *buttonNumber = buttonState[kMFButtonModificationPreconditionKeyButtonNumber];
-        
-        if (buttonNumber.intValue == button) {
-            
-            [state removeObjectAtIndex:i];
-            return YES;
-        }
+    /// Debug
+    if (runningPreRelease()) {
+        NSString *description = stateDescription(&_stack);
+        DDLogDebug(@"buttonModifiers - update - toState: %@", description);
     }
     
-    return NO;
-}
-
-/// Debug
-
-static NSString *stateDescription(ButtonModifierState state) {
-    
-    NSMutableString *result = [NSMutableString string];
-    BOOL isFirstIteration = YES;
+    /// Notify
+    [Modifiers buttonModsChangedTo:modifierStateFromStack(&_stack)];
     
-    for (NSDictionary *buttonState in state) {
-        
-        if (!isFirstIteration) [result appendString:@" "];
-        isFirstIteration = NO;
-        
-        NSString *elementString = stringf(@"(%@, %@)", buttonState[kMFButtonModificationPreconditionKeyButtonNumber], buttonState[kMFButtonModificationPreconditionKeyClickLevel]);
-        [result appendString:elementString];
-    }
+    /// Publish for other threads
+    ///     Do this after notifying `Modifiers`. That way, a reader that sees the new stack is guaranteed to also get the new modifiers from `Modifiers`. (ScrollModifiers relies on that for its cache)
+    publish(&_stack);
     
-    return result;
+    /// Publish for mainApp
+    uint32_t count = _stack.count;
+    uint64_t signature = _stack.signature;
+    MFSharedStatusUpdate(^(MFSharedStatus *status) {
+        status->buttonModifierCount = count;
+        status->buttonModifierSignature = signature;
+    });
 }
 
 
@@ -0,0 +1,140 @@
+//
+// --------------------------------------------------------------------------
+// ButtonTriggerPlan.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Precomputed answer to "which action array do we execute for this trigger?" for one button under one set of modifications.
+///
+/// __Why__
+/// - `Buttons.handleInput()` used to call `RemapsAnalyzer.assessMappingLandscape()` inside every trigger callback, then build a Swift Dictionary mapping trigger phases to actions, and then do 3 nested NSDictionary lookups to find the action array. The landscape analysis iterates over all the modification preconditions in the remaps.
+/// - None of that depends on anything other than the button, the click level and the modifications. And the modifications are cached by `Remap` per modifier state, so we usually get the exact same object again.
+///
+/// __How__
+/// - When a clickCycle starts, `Buttons` gets the plan for (modifications, button) from the cache, or builds it. Building does everything the trigger callback used to do, for every click level up to `maxClickLevel`, and stores the result in a flat array indexed by click level and trigger phase.
+/// - In the trigger callback, `step(clickLevel:triggerPhase:)` is just an array access.
+///
+/// __Notes__
+/// - The cache is keyed by the identity of the modifications dict. We keep the modifications alive in the plan, so the identity can't be reused by another object. The cache is cleared when `Remap.remaps` changes, since `Remap` then creates new modifications dicts, too.
+/// - Only use this from `Buttons.queue`. The cache isn't synchronized.
+
+import Foundation
+import CocoaLumberjackSwift
+
+final class ButtonTriggerPlan {
+
+    /// Types
+
+    struct Step {
+        let actionArray: NSArray
+        let actionPhase: MFActionPhase /// `kMFActionPhaseCombined` or `kMFActionPhaseStart`
+    }
+
+    /// Storage
+
+    let maxClickLevel: Int
+    private let steps: [Step?] /// Index: `(clickLevel-1) * phaseCount + triggerPhase.rawValue`
+    private let modifications: NSDictionary /// Only stored to keep the cache key alive
+
+    private static let phaseCount = ClickCycleTriggerPhase.releaseFromHold.rawValue + 1
+
+    /// Lookup
+
+    @inline(__always) func step(clickLevel: Int, triggerPhase: ClickCycleTriggerPhase) -> Step? {
+        guard clickLevel >= 1, clickLevel <= maxClickLevel, triggerPhase.rawValue >= 0 else { return nil }
+        return steps[(clickLevel-1) * ButtonTriggerPlan.phaseCount + triggerPhase.rawValue]
+    }
+
+    /// Cache
+
+    private struct Key: Hashable {
+        let modifications: ObjectIdentifier
+        let button: Int
+    }
+    private static var cache: [Key: ButtonTriggerPlan] = [:]
+    private static var cacheRemaps: NSDictionary? = nil
+
+    static func plan(button: NSNumber, modifications: NSDictionary, remaps: NSDictionary) -> ButtonTriggerPlan {
+
+        /// Invalidate
+        if remaps !== cacheRemaps {
+            cache.removeAll(keepingCapacity: true)
+            cacheRemaps = remaps
+        }
+
+        /// Lookup
+        let key = Key(modifications: ObjectIdentifier(modifications), button: button.intValue)
+        if let cached = cache[key] {
+            return cached
+        }
+
+        /// Build
+        let new = ButtonTriggerPlan(button: button, modifications: modifications, remaps: remaps)
+        cache[key] = new
+        return new
+    }
+
+    /// Init
+
+    private init(button: NSNumber, modifications: NSDictionary, remaps: NSDictionary) {
+
+        self.modifications = modifications
+
+        /// Get max clickLevel
+        let maxClickLevel = RemapsAnalyzer.maxLevel(forButton: button, remaps: remaps, modificationsActingOnThisButton: modifications)
+        self.maxClickLevel = maxClickLevel
+
+        var steps = [Step?](repeating: nil, count: maxClickLevel * ButtonTriggerPlan.phaseCount)
+
+        for clickLevel in stride(from: 1, through: maxClickLevel, by: 1) {
+
+            /// Asses 'mappingLandscape'
+
+            var clickActionOfThisLevelExists: ObjCBool = false
+            var effectForMouseDownStateOfThisLevelExists: ObjCBool = false
+            var effectOfGreaterLevelExists: ObjCBool = false
+
+            RemapsAnalyzer.assessMappingLandscape(withButton: button, level: clickLevel as NSNumber, modificationsActingOnThisButton: modifications, remaps: remaps, thisClickDoBe: &clickActionOfThisLevelExists, thisDownDoBe: &effectForMouseDownStateOfThisLevelExists, greaterDoBe: &effectOfGreaterLevelExists)
+
+            /// Create trigger -> action map based on mappingLandscape
+
+            var map: [(ClickCycleTriggerPhase, String, MFActionPhase)] = []
+
+            /// Map for click actions
+            if clickActionOfThisLevelExists.boolValue {
+                if effectOfGreaterLevelExists.boolValue {
+                    map.append((.levelExpired, "click", kMFActionPhaseCombined))
+                } else if effectForMouseDownStateOfThisLevelExists.boolValue {
+                    map.append((.release, "click", kMFActionPhaseCombined))
+//                    map.append((.releaseFromHold, "click", kMFActionPhaseCombined))
+                } else {
+                    map.append((.press, "click", kMFActionPhaseStart))
+                }
+            }
+
+            /// Map for hold actions
+            if effectForMouseDownStateOfThisLevelExists.boolValue {
+                map.append((.hold, "hold", kMFActionPhaseStart))
+            }
+
+            /// Resolve actionArrays
+            for (triggerPhase, duration, actionPhase) in map {
+                guard
+                    let m1 = modifications.object(forKey: button) as? NSDictionary,
+                    let m2 = m1.object(forKey: clickLevel) as? NSDictionary,
+                    let actionArray = m2.object(forKey: duration) as? NSArray /// Not nil -> a click/hold action does exist for this button + level + duration
+                else {
+                    continue
+                }
+                steps[(clickLevel-1) * ButtonTriggerPlan.phaseCount + triggerPhase.rawValue] = Step(actionArray: actionArray, actionPhase: actionPhase)
+            }
+        }
+
+        self.steps = steps
+
+        DDLogDebug("ButtonTriggerPlan - built plan for button \(button) with maxClickLevel \(maxClickLevel)")
+    }
+}
@@ -24,6 +24,8 @@ import CocoaLumberjackSwift
     /// Vars that we only update once per clickCycle
     static var modifiers = NSDictionary()
     static var modifications = NSDictionary()
+    static var triggerPlan: ButtonTriggerPlan? = nil /// See ButtonTriggerPlan.swift
+    static private let emptyModifications = NSDictionary()
     static var maxClickLevel: Int = -1
     
     /// Init
@@ -57,13 +59,13 @@ import CocoaLumberjackSwift
             /// Update modifications
             let remaps = Remap.remaps /// Why aren't we reusing the remaps from above?
             self.modifiers = Modifiers.modifiers(with: event)
-            self.modifications = Remap.modifications(withModifiers: modifiers) ?? NSDictionary()
+            self.modifications = Remap.modifications(withModifiers: modifiers) ?? emptyModifications /// Use the same empty dict every time, so the trigger plan for it can be cached
             
-            /// Get max clickLevel
-            self.maxClickLevel = 0
-            if mouseDown {
-                self.maxClickLevel = RemapsAnalyzer.maxLevel(forButton: button, remaps: remaps, modificationsActingOnThisButton: modifications)
-            }
+            /// Get trigger plan
+            ///     This contains the max clickLevel and all the actions that the trigger callback might execute during this clickCycle. Usually it's cached.
+            let plan = ButtonTriggerPlan.plan(button: button, modifications: modifications, remaps: remaps)
+            self.triggerPlan = plan
+            self.maxClickLevel = plan.maxClickLevel
             
         }
         
@@ -96,52 +98,13 @@ import CocoaLumberjackSwift
             /// Debug
             DDLogDebug("triggerCallback - lvl: \(clickLevel), phase: \(triggerPhase), btn: \(buttonNumber), dev: \"\(device.name())\"")
             
-            /// Asses 'mappingLandscape'
-            ///     In theory we only have to do this on mouse down, because on mouse up the clickLevel doesn't change, and so no params for `assessMappingLandscape()` change
-            
-            var clickActionOfThisLevelExists: ObjCBool = false
-            var effectForMouseDownStateOfThisLevelExists: ObjCBool = false
-            var effectOfGreaterLevelExists: ObjCBool = false
-            
-            RemapsAnalyzer.assessMappingLandscape(withButton: button as NSNumber, level: clickLevel as NSNumber, modificationsActingOnThisButton: modifications, remaps: remaps, thisClickDoBe: &clickActionOfThisLevelExists, thisDownDoBe: &effectForMouseDownStateOfThisLevelExists, greaterDoBe: &effectOfGreaterLevelExists)
-            
-            /// Create trigger -> action map based on mappingLandscape
-            
-            var map: [ClickCycleTriggerPhase: (String, MFActionPhase)] = Dictionary(minimumCapacity: 3)
-            
-            /// Map for click actions
-            if clickActionOfThisLevelExists.boolValue {
-                if effectOfGreaterLevelExists.boolValue {
-                    map[.levelExpired]          = ("click", kMFActionPhaseCombined)
-                } else if effectForMouseDownStateOfThisLevelExists.boolValue {
-                    map[.release]               = ("click", kMFActionPhaseCombined)
-//                    map[.releaseFromHold]       = ("click", kMFActionPhaseCombined)
-                } else {
-                    map[.press]                 = ("click", kMFActionPhaseStart)
-                }
-            }
-            
-            /// Map for hold actions
-            if effectForMouseDownStateOfThisLevelExists.boolValue {
-                map[.hold]                  = ("hold", kMFActionPhaseStart)
-            }
-            
             /// Get action for current trigger
-            ///     This code is horrible to write in Swift. Deal with remapsDict in Objc whenever possible
-            
-            /// Get actionArray
-            guard
-                let (duration, startOrEnd) = map[triggerPhase],
-//                let m1 = modifications[button] as? [AnyHashable: Any],
-                let m1 = modifications.object(forKey: button) as? NSDictionary,
-//                let m2 = m1[clickLevel as NSNumber] as? [AnyHashable: Any],
-                let m2 = m1.object(forKey: clickLevel) as? NSDictionary,
-//                let m3 = m2[duration],
-                let actionArray = m2.object(forKey: duration) as? NSArray /// Not nil -> a click/hold action does exist for this button + level + duration
-//                let actionArray = m3 as? [[AnyHashable: Any]]
-            else {
+            ///     The mappingLandscape analysis and the lookup of the actionArray have been done when the plan was built. See ButtonTriggerPlan.swift
+            guard let step = self.triggerPlan?.step(clickLevel: clickLevel, triggerPhase: triggerPhase) else {
                 return /// Return if there's no action array to send
             }
+            let actionArray = step.actionArray
+            let startOrEnd = step.actionPhase
             
             /// Add modifiers to actionArray for addMode. See Remap -> addMode for context
             ///     Edit: We don't need this anymore now that we're using the addModeSwizzler
@@ -0,0 +1,171 @@
+//
+// --------------------------------------------------------------------------
+// DeviceProfiles.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Per-device settings.
+///
+/// __Why__
+/// - So far, all settings apply to all mice the same. But if you use e.g. a gaming mouse with a high-res, free-spinning wheel and a cheap office mouse, you might want different scroll settings for them.
+///
+/// __How__
+/// - Profiles live in the `DeviceProfiles` section of the config. Each profile has a `match` dict and a `Scroll` dict:
+///     ```
+///     DeviceProfiles: [
+///         { match: { vendorID: Int, productID: Int, serial: String },     (All keys are optional. All given keys need to be equal.)
+///           Scroll: { ... } },                                            (Same structure as the `Scroll` section. Overrides values from it.)
+///     ]
+///     ```
+///     If several profiles match a device, the one with the most keys in its `match` dict wins. (So a profile for one specific serial beats a profile for the whole product.) If there's still a tie, the first one wins.
+/// - When DeviceManager attaches a device, we resolve its profile and 'compile' it into a base `ScrollConfig` with the profile's values applied. That's stored in a table under the device's `deviceIndex` (See DeviceRegistry.m).
+/// - Scroll.m gets the base config for the active device's index when it updates its `_scrollConfig` on the first consecutive tick. Everything after that (modifiers, display, caching the derived configs) works the same as before. So there's no extra work per scroll tick, and nothing in the event path needs to know which device it's dealing with.
+/// - When the config changes, we re-resolve the profiles of all attached devices.
+///
+/// __Notes__
+/// - Devices without a profile don't get an entry, so they use `ScrollConfig.shared` exactly like before.
+/// - Only scroll settings are per-device so far. PointerConfig is all static and PointerSpeed doesn't configure individual devices at the moment (see DeviceManager `handleDeviceMatching()`), and Remaps aren't device-specific anywhere. Those could get their own entries in the profile dict later.
+/// - There's no UI for this. You have to edit config.plist by hand, and the helper only picks that up when it starts. So disable Mac Mouse Fix in the UI, edit the file, and enable it again. (See ScrollConfig > Experiment for why editing while the helper runs doesn't work.) `reload()` only runs when the app changes the `Scroll` or `DeviceProfiles` section through `Config`.
+/// - Attaching, removing and reloading happen on the main thread, reading happens on the scroll queue, so we access the table under a lock. That only happens once per scroll swipe.
+
+import Foundation
+import CocoaLumberjackSwift
+
+@objc class DeviceProfiles: NSObject {
+
+    // MARK: Types
+
+    private final class Snapshot {
+
+        /// The compiled profile for one attached device
+
+        let profileIndex: Int           /// Index into the `DeviceProfiles` array of the config. Just for debugging.
+        let scrollConfig: ScrollConfig  /// Base config for `ScrollConfig.scrollConfig(modifiers:inputAxis:display:base:)`
+
+        init(profileIndex: Int, scrollConfig: ScrollConfig) {
+            self.profileIndex = profileIndex
+            self.scrollConfig = scrollConfig
+        }
+    }
+
+    // MARK: Storage
+
+    private static let lock = NSObject()
+    private static var snapshots = [Snapshot?](repeating: nil, count: Int(kMFDeviceRegistryCapacity)) /// Indexed by `Device.deviceIndex`
+
+    // MARK: Interface
+
+    @objc static func scrollConfig(forDeviceIndex index: Int32) -> ScrollConfig {
+
+        /// Returns the base scrollConfig for the device at `index`. That's `ScrollConfig.shared` unless the device has a profile.
+
+        let snapshot: Snapshot? = synchronized(lock) {
+            guard index >= 0, index < snapshots.count else { return nil }
+            return snapshots[Int(index)]
+        }
+        return snapshot?.scrollConfig ?? ScrollConfig.shared
+    }
+
+    @objc static func deviceAttached(_ device: Device) {
+
+        /// Call this after DeviceManager has assigned the `deviceIndex`
+
+        let index = Int(device.deviceIndex)
+        guard index >= 0, index < snapshots.count else { return }
+
+        let snapshot = resolve(device, profiles: profiles)
+        synchronized(lock) {
+            snapshots[index] = snapshot
+        }
+
+        if let snapshot = snapshot {
+            DDLogInfo("DeviceProfiles - Using profile \(snapshot.profileIndex) for device \(device.name())")
+        }
+    }
+
+    @objc static func deviceRemoved(_ device: Device) {
+
+        /// Call this before DeviceManager resets the `deviceIndex`
+
+        let index = Int(device.deviceIndex)
+        guard index >= 0, index < snapshots.count else { return }
+
+        synchronized(lock) {
+            snapshots[index] = nil
+        }
+    }
+
+    @objc static func reload() {
+
+        /// Call this when the `DeviceProfiles` or `Scroll` section of the config changes.
+        ///     The base configs need to be recreated after `ScrollConfig.reload()` too, because they read all the values that the profile doesn't override from the `Scroll` section.
+
+        let profiles = self.profiles
+
+        var newSnapshots = [Snapshot?](repeating: nil, count: Int(kMFDeviceRegistryCapacity))
+        for case let device as Device in DeviceManager.attachedDevices {
+            let index = Int(device.deviceIndex)
+            guard index >= 0, index < newSnapshots.count else { continue }
+            newSnapshots[index] = resolve(device, profiles: profiles)
+        }
+
+        synchronized(lock) {
+            snapshots = newSnapshots
+        }
+    }
+
+    // MARK: Resolve
+
+    private static var profiles: [NSDictionary] {
+        return (config(kMFConfigKeyDeviceProfiles) as? [NSDictionary]) ?? []
+    }
+
+    private static func resolve(_ device: Device, profiles: [NSDictionary]) -> Snapshot? {
+
+        /// Find the most specific matching profile
+
+        var best: (index: Int, specificity: Int)? = nil
+
+        for (i, profile) in profiles.enumerated() {
+            guard let match = profile["match"] as? NSDictionary else { continue }
+            guard let specificity = matchSpecificity(match, device: device) else { continue }
+            if best == nil || specificity > best!.specificity {
+                best = (i, specificity)
+            }
+        }
+
+        /// Compile
+
+        guard let best = best else { return nil }
+        let scrollOverrides = profiles[best.index][kMFConfigKeyScroll] as? NSDictionary
+        guard let scrollOverrides = scrollOverrides, scrollOverrides.count > 0 else { return nil }
+
+        return Snapshot(profileIndex: best.index, scrollConfig: ScrollConfig(profileOverrides: scrollOverrides.copy() as? NSDictionary))
+    }
+
+    private static func matchSpecificity(_ match: NSDictionary, device: Device) -> Int? {
+
+        /// Returns the number of keys in `match` if they all equal the device's values. Otherwise nil.
+        ///     A `match` dict without any of the keys below matches every device.
+
+        var specificity = 0
+
+        if let vendorID = match["vendorID"] as? NSNumber {
+            guard vendorID == device.vendorID() else { return nil }
+            specificity += 1
+        }
+        if let productID = match["productID"] as? NSNumber {
+            guard productID == device.productID() else { return nil }
+            specificity += 1
+        }
+        if let serial = match["serial"] as? String {
+            guard serial == device.serialNumber() else { return nil }
+            specificity += 1
+        }
+
+        return specificity
+    }
+}
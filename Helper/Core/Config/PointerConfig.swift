@@ -42,7 +42,7 @@ class PointerConfig: NSObject {
 
     /// Reload from config dict
     @objc static func reload() {
-        // TODO: Delete caches (if you use any)
+        curveParamsVersion.bump()
     }
     
     /// Get pointer settings from config
@@ -79,7 +79,7 @@ class PointerConfig: NSObject {
     // MARK: Polling rate compensation
     ///  See top of the file for explanation
     private static let basePollingRate = 125
-    private static var actualPollingRate = 125
+    private static var actualPollingRate = 125 { didSet { curveParamsVersion.bump() } }
     private static var pollingRateRatio: Double {
         Double(actualPollingRate) / Double(basePollingRate)
     }
@@ -107,16 +107,24 @@ class PointerConfig: NSObject {
     @objc static var useParametricCurve: Bool = false /// Switch between table-based and parametric curve. Once parametric has been used you can't switch back until you detach the device.
     
     /// User defined params
-    @objc static var u_speed: Double = 0.5
-    @objc static var u_complexSettings: Bool = false /// Switch nbetwee using just `u_speed` or the fine-grained params below
-    @objc static var u_minSens: Double = 1.0
-    @objc static var u_maxSens: Double = 0.5
-    @objc static var u_curvature: Double = 0.5
-    @objc static var u_turnOffAcceleration: Bool = false
-    @objc static var u_unacceleratedSens: Double = 1.0
+    @objc static var u_speed: Double = 0.5 { didSet { curveParamsVersion.bump() } }
+    @objc static var u_complexSettings: Bool = false { didSet { curveParamsVersion.bump() } } /// Switch nbetwee using just `u_speed` or the fine-grained params below
+    @objc static var u_minSens: Double = 1.0 { didSet { curveParamsVersion.bump() } }
+    @objc static var u_maxSens: Double = 0.5 { didSet { curveParamsVersion.bump() } }
+    @objc static var u_curvature: Double = 0.5 { didSet { curveParamsVersion.bump() } }
+    @objc static var u_turnOffAcceleration: Bool = false { didSet { curveParamsVersion.bump() } }
+    @objc static var u_unacceleratedSens: Double = 1.0 { didSet { curveParamsVersion.bump() } }
+    
+    /// Cache
+    ///     Bumped whenever anything that the curves are calculated from changes. Calculating `tableBasedCurve` samples and interpolates 1000+ points, so we don't want to redo that every time PointerSpeed asks for it.
+    private static let curveParamsVersion = VersionStamp()
+    private static let _tableBasedCurve = DerivedProperty.create(given: [curveParamsVersion]) { PointerConfig.calculateTableBasedCurve() }
     
     /// Generate curves
     @objc static var tableBasedCurve: [[Double]] {
+        return _tableBasedCurve()
+    }
+    private static func calculateTableBasedCurve() -> [[Double]] {
         
         /// Debug - test mouse speed
 //        let testCurve = TestAccelerationCurve(thresholdSpeed: 3.0, firstSens: 0.0, secondSens: 2.0)
@@ -23,9 +23,24 @@ import CocoaLumberjackSwift
     
     private static var _scrollConfigRaw: NSDictionary? = nil /// This needs to be static, not an instance var. Otherwise there are weird crashes in Scroll.m. Not sure why.
     private func c(_ keyPath: String) -> NSObject? {
+        if let fromProfile = profileOverrides?.object(forCoolKeyPath: keyPath) {
+            return fromProfile
+        }
         return ScrollConfig._scrollConfigRaw?.object(forCoolKeyPath: keyPath) /// Not sure whether to use coolKeyPath here?
     }
     
+    // MARK: Device profiles
+    ///     Notes:
+    ///     - `profileOverrides` has the same structure as the `Scroll` section of the config and overrides values from it. It's set on the base configs that `DeviceProfiles` creates for devices that have a profile. See DeviceProfiles.swift.
+    ///     - It's only a reference to an immutable dict, which is why it can live on the instance, unlike `_scrollConfigRaw`. It needs to be @objc, so that `copy()` carries it over.
+    
+    @objc var profileOverrides: NSDictionary? = nil
+    
+    @objc convenience init(profileOverrides: NSDictionary?) {
+        self.init()
+        self.profileOverrides = profileOverrides
+    }
+    
     // MARK: Static functions
     
     @objc private(set) static var shared = ScrollConfig() /// Singleton instance
@@ -45,24 +60,24 @@ import CocoaLumberjackSwift
         /// - TODO: Make a copy before storing in `_scrollConfigRaw` just to be sure the equality checks always work
         shared = ScrollConfig()
         _scrollConfigRaw = newConfigRaw
-        cache = nil
 //        ReactiveScrollConfig.shared.handleScrollConfigChanged(newValue: shared)
         SwitchMaster.shared.scrollConfigChanged(scrollConfig: shared)
     }
-    private static var cache: [_HT<MFScrollModificationResult, MFAxis, CGDirectDisplayID>: ScrollConfig]? = nil
+    /// Cache for `scrollConfig(modifiers:inputAxis:display:base:)`
+    ///     Lives on the base config, so it's thrown away together with the base when the config reloads or a device profile is re-resolved. Not @objc, so `copy()` doesn't carry it over.
+    private var derivedConfigs: [_HT<MFScrollModificationResult, MFAxis, CGDirectDisplayID>: ScrollConfig] = [:]
     
     // MARK: Overrides
     
-    @objc static func scrollConfig(modifiers: MFScrollModificationResult, inputAxis: MFAxis, display: CGDirectDisplayID) -> ScrollConfig {
+    @objc static func scrollConfig(modifiers: MFScrollModificationResult, inputAxis: MFAxis, display: CGDirectDisplayID, base: ScrollConfig) -> ScrollConfig {
+        
+        /// `base` is `ScrollConfig.shared`, or the base config of the device's profile. (See `DeviceProfiles.scrollConfig(forDeviceIndex:)`)
         
         /// Try to get result from cache
         
-        if cache == nil {
-            cache = .init()
-        }
         let key = _HT(a: modifiers, b: inputAxis, c: display)
         
-        if let fromCache = cache![key] {
+        if let fromCache = base.derivedConfigs[key] {
             return fromCache
 
         } else {
@@ -70,7 +85,7 @@ import CocoaLumberjackSwift
             /// Cache retrieval failed -> Recalculate result
             
             /// Copy og settings
-            let new = shared.copy() as! ScrollConfig
+            let new = base.copy() as! ScrollConfig
             
             /// Declare overridables
             var u_speed = new.u_speed
@@ -208,16 +223,64 @@ import CocoaLumberjackSwift
             if u_speed == kMFScrollSpeedSystem && !usePreciseMod && !useQuickMod {
                 new.accelerationCurve = nil
             } else {
-                new.accelerationCurve = getAccelerationCurve(forSpeed: u_speed, precise: precise, smoothness: new.u_smoothness, animationCurve: new.animationCurve, inputAxis: inputAxis, display: display, scaleToDisplay: scaleToDisplay, modifiers: modifiers, useQuickModSpeed: useQuickMod, usePreciseModSpeed: usePreciseMod, consecutiveScrollTickIntervalMax: new.consecutiveScrollTickIntervalMax, consecutiveScrollTickInterval_AccelerationEnd: new.consecutiveScrollTickInterval_AccelerationEnd)
+                new.accelerationCurve = getAccelerationCurve(forSpeed: u_speed, precise: precise, smoothness: new.u_smoothness, animationCurve: new.animationCurve, inputAxis: inputAxis, display: display, scaleToDisplay: scaleToDisplay, modifiers: modifiers, useQuickModSpeed: useQuickMod, usePreciseModSpeed: usePreciseMod, consecutiveScrollTickIntervalMax: new.consecutiveScrollTickIntervalMax, consecutiveScrollTickInterval_AccelerationEnd: new.consecutiveScrollTickInterval_AccelerationEnd, experiment: new.accelerationExperiment)
             }
             
             /// Cache & return
-            cache![key] = new
+            base.derivedConfigs[key] = new
             return new
             
         }
     }
     
+    // MARK: Experiment
+    
+    /// Notes:
+    /// - This lets you swap out and re-parameterize the stages of the scroll pipeline (tickTime smoother -> acceleration curve -> fastScroll curve -> animation curve) from the config file instead of editing code and rebuilding. So far, we've done tuning by toggling `if ((NO))` blocks and commenting alternatives in and out. (See ScrollConfigTesting.md)
+    /// - To use it, add an `experiment` dict to the `Scroll` section of config.plist. The dict isn't part of default_config.plist, so it doesn't exist for normal users.
+    ///     - The helper doesn't watch config.plist (see `setupFSEventStreamCallback`), it only reloads sections that the app changes through `Config`. So to apply hand edits, disable Mac Mouse Fix in the UI (or quit the helper), edit the file, then enable it again - the helper reads the file fresh when it starts.
+    ///     - Don't edit while the helper is running. Its next config write rewrites config.plist from memory and drops your edit. (Editing changes the file's fingerprint, so the helper can't append to `config.journal` and compacts instead. See Config.m)
+    /// - Structure (all keys are optional):
+    ///     ```
+    ///     smoother:           { type: "rollingAverage" | "exponential" | "doubleExponential" | "none", capacity: Int, a: Double, y: Double }
+    ///     acceleration:       { minSens: Double, maxSens: Double, curvature: Double }
+    ///     fastScroll:         { swipeThreshold: Int, initialSpeedup: Double, exponentialSpeedup: Double }   (or `false` to turn fastScroll off)
+    ///     animationCurve:     { baseMsPerStep: Int, dragExponent: Double, dragCoefficient: Double, stopSpeed: Int, speedSmoothing: Double }
+    ///     ```
+    /// - The `animationCurve` overrides only apply to curves that use the dragCurve. Modifiers like quickScroll or preciseScroll still override the experiment values.
+    
+    private func e(_ keyPath: String) -> NSObject? {
+        return c("experiment." + keyPath)
+    }
+    
+    @objc lazy var tickTimeSmootherSpec: NSDictionary? = { e("smoother") as? NSDictionary }()
+    fileprivate lazy var accelerationExperiment: NSDictionary? = { e("acceleration") as? NSDictionary }()
+    fileprivate lazy var animationCurveExperiment: NSDictionary? = { e("animationCurve") as? NSDictionary }()
+    
+    @objc static func tickTimeSmoother(spec: NSDictionary?) -> NSObject & Smoother {
+        
+        /// Creates the smoother that ScrollAnalyzer uses for `timeBetweenTicks`. `nil` returns the default. (See ScrollAnalyzer `+ initialize` for why we use that one)
+        
+        guard let spec = spec else {
+            return RollingAverage(capacity: 3)
+        }
+        
+        let type = spec["type"] as? String ?? "rollingAverage"
+        switch type {
+        case "none":
+            return RollingAverage(capacity: 1) /// Capacity 1 turns off smoothing
+        case "exponential":
+            return ExponentialSmoother(a: spec["a"] as? Double ?? 0.5)
+        case "doubleExponential":
+            return DoubleExponentialSmoother(a: spec["a"] as? Double ?? 0.5, y: spec["y"] as? Double ?? 0.2)
+        case "rollingAverage":
+            return RollingAverage(capacity: spec["capacity"] as? Int ?? 3)
+        default:
+            DDLogError("ScrollConfig - Unknown experiment smoother type \(type). Using default.")
+            return RollingAverage(capacity: 3)
+        }
+    }
+    
     // MARK: ???
     
     @objc static var linearCurve: Bezier = { () -> Bezier in
@@ -225,6 +288,7 @@ import CocoaLumberjackSwift
         let controlPoints: [P] = [_P(0,0), _P(0,0), _P(1,1), _P(1,1)]
         
         return Bezier(controlPoints: controlPoints, defaultEpsilon: 0.001) /// The default defaultEpsilon 0.08 makes the animations choppy
+            .calibrateEpsilonNow(forResolution: animationCurveEpsilonResolution, tolerance: animationCurveEpsilonTolerance) /// Created only once, so calibrating in the background wouldn't help
     }()
     
 //    @objc static var stringToEventFlagMask: NSDictionary = ["command" : CGEventFlags.maskCommand,
@@ -366,6 +430,18 @@ import CocoaLumberjackSwift
     
     @objc lazy var fastScrollCurve: ScrollSpeedupCurve? = {
         
+        /// Experiment override
+        
+        if let ovr = e("fastScroll") {
+            if let ovr = ovr as? NSDictionary {
+                return ScrollSpeedupCurve(swipeThreshold: ovr["swipeThreshold"] as? Int ?? 3,
+                                          initialSpeedup: ovr["initialSpeedup"] as? Double ?? 1.33,
+                                          exponentialSpeedup: ovr["exponentialSpeedup"] as? Double ?? 7.5)
+            } else if (ovr as? Bool) == false {
+                return nil as ScrollSpeedupCurve?
+            }
+        }
+        
         /// NOTES:
         /// - We're using swipeThreshold to configure how far the user must've scrolled before fastScroll starts kicking in.
         /// - It would probably be better to have an explicit mechanism that counts how many pixels the user has scrolled already and then lets fastScroll kick in after a threshold is reached. That would also scale with the scrollSpeed setting. These current `fastScrollSpeedup` values are chosen so you don't accidentally trigger it at the lowest scrollSpeed, but they could be higher at higher scrollspeeds.
@@ -433,13 +509,13 @@ import CocoaLumberjackSwift
         
         set {
             _animationCurveName = newValue
-            self.animationCurveParams = animationCurveParamsMap(name: animationCurve)
+            self.animationCurveParams = animationCurveParamsMap(name: animationCurve)?.applyingExperiment(animationCurveExperiment)
         } get {
             return _animationCurveName
         }
     }
     
-    @objc private(set) lazy var animationCurveParams: MFScrollAnimationCurveParameters? = { animationCurveParamsMap(name: animationCurve) }() /// Updates automatically to match `self.animationCurveName
+    @objc private(set) lazy var animationCurveParams: MFScrollAnimationCurveParameters? = { animationCurveParamsMap(name: animationCurve)?.applyingExperiment(animationCurveExperiment) }() /// Updates automatically to match `self.animationCurveName
     
     // MARK: Acceleration
     
@@ -539,8 +615,34 @@ import CocoaLumberjackSwift
         self.sendGestureScrolls = sendGestureScrolls
         self.sendMomentumScrolls = false
     }
+    
+    /// Experiment
+    func applyingExperiment(_ experiment: NSDictionary?) -> MFScrollAnimationCurveParameters {
+        
+        /// Returns a copy with the values from the `animationCurve` experiment dict applied. See ScrollConfig > Experiment.
+        
+        guard let x = experiment, useDragCurve else { return self }
+        
+        let speedSmoothing = x["speedSmoothing"] as? Double ?? self.speedSmoothing
+        let baseMsPerStep = x["baseMsPerStep"] as? Int ?? self.baseMsPerStep
+        
+        return MFScrollAnimationCurveParameters(baseCurve: speedSmoothing != -1 ? nil : self.baseCurve,
+                                                speedSmoothing: speedSmoothing,
+                                                baseMsPerStepCurve: baseMsPerStep != -1 ? nil : self.baseMsPerStepCurve,
+                                                baseMsPerStep: baseMsPerStep,
+                                                dragExponent: x["dragExponent"] as? Double ?? self.dragExponent,
+                                                dragCoefficient: x["dragCoefficient"] as? Double ?? self.dragCoefficient,
+                                                stopSpeed: x["stopSpeed"] as? Int ?? self.stopSpeed,
+                                                sendGestureScrolls: self.sendGestureScrolls,
+                                                sendMomentumScrolls: self.sendMomentumScrolls)
+    }
 }
 
+/// Resolution that animation baseCurves are calibrated for. See `Bezier > Epsilon calibration`.
+///     1.5 s (TouchAnimator's maxAnimationDuration) at 120 fps would be 180 frames, so 1000 leaves plenty of headroom.
+fileprivate let animationCurveEpsilonResolution = 1000
+fileprivate let animationCurveEpsilonTolerance = 1e-4 /// The y axis of baseCurves is the fraction of the animation's distance. So for a 1000 px animation, this is 0.1 px.
+
 fileprivate func animationCurveParamsMap(name: MFScrollAnimationCurveName) -> MFScrollAnimationCurveParameters? {
     
     /// Map from animationCurveName -> animationCurveParams
@@ -560,7 +662,7 @@ fileprivate func animationCurveParamsMap(name: MFScrollAnimationCurveName) -> MF
         fatalError()
         
         let baseCurve =
-        Bezier(controlPoints: [_P(0, 0), _P(0, 0), _P(0.66, 1), _P(1, 1)], defaultEpsilon: 0.001)
+        Bezier(controlPoints: [_P(0, 0), _P(0, 0), _P(0.66, 1), _P(1, 1)], defaultEpsilon: 0.001).calibrateEpsilon(forResolution: animationCurveEpsilonResolution, tolerance: animationCurveEpsilonTolerance)
 //            Bezier(controlPoints: [_P(0, 0), _P(0.31, 0.44), _P(0.66, 1), _P(1, 1)], defaultEpsilon: 0.001)
 //            ScrollConfig.linearCurve
 //            Bezier(controlPoints: [_P(0, 0), _P(0.23, 0.89), _P(0.52, 1), _P(1, 1)], defaultEpsilon: 0.001)
@@ -678,7 +780,7 @@ fileprivate func animationCurveParamsMap(name: MFScrollAnimationCurveName) -> MF
     case kMFScrollAnimationCurveNameTouchDriver:
 
         /// v Note: At the time of writing, this curve is equivalent to a BezierCappedAccelerationCurve with curvature 1.
-        let baseCurve = Bezier(controlPoints: [_P(0, 0), _P(0, 0), _P(0.5, 1), _P(1, 1)], defaultEpsilon: 0.001)
+        let baseCurve = Bezier(controlPoints: [_P(0, 0), _P(0, 0), _P(0.5, 1), _P(1, 1)], defaultEpsilon: 0.001).calibrateEpsilon(forResolution: animationCurveEpsilonResolution, tolerance: animationCurveEpsilonTolerance)
         return MFScrollAnimationCurveParameters(baseCurve: baseCurve, msPerStep: /*225*/250/*275*/, sendGestureScrolls: false)
         
     case kMFScrollAnimationCurveNameTouchDriverLinear:
@@ -711,7 +813,7 @@ fileprivate func animationCurveParamsMap(name: MFScrollAnimationCurveName) -> MF
 }
 
 /// Define function that maps userSettings -> accelerationCurve
-fileprivate func getAccelerationCurve(forSpeed speedArg: MFScrollSpeed, precise: Bool, smoothness: MFScrollSmoothness, animationCurve: MFScrollAnimationCurveName, inputAxis: MFAxis, display: CGDirectDisplayID, scaleToDisplay: Bool, modifiers: MFScrollModificationResult, useQuickModSpeed: Bool, usePreciseModSpeed: Bool, consecutiveScrollTickIntervalMax: Double, consecutiveScrollTickInterval_AccelerationEnd: Double) -> Curve {
+fileprivate func getAccelerationCurve(forSpeed speedArg: MFScrollSpeed, precise: Bool, smoothness: MFScrollSmoothness, animationCurve: MFScrollAnimationCurveName, inputAxis: MFAxis, display: CGDirectDisplayID, scaleToDisplay: Bool, modifiers: MFScrollModificationResult, useQuickModSpeed: Bool, usePreciseModSpeed: Bool, consecutiveScrollTickIntervalMax: Double, consecutiveScrollTickInterval_AccelerationEnd: Double, experiment: NSDictionary?) -> Curve {
     
     /// Notes:
     /// - The inputs to the curve can sometimes be ridiculously high despite smoothing, because our time measurements of when ticks occur are very imprecise
@@ -864,6 +966,15 @@ fileprivate func getAccelerationCurve(forSpeed speedArg: MFScrollSpeed, precise:
 //    }
 //    maxSens += screenHeightSummand
     
+    /// Apply experiment
+    ///     See ScrollConfig > Experiment
+    
+    if let x = experiment {
+        minSens = x["minSens"] as? Double ?? minSens
+        maxSens = x["maxSens"] as? Double ?? maxSens
+        curvature = x["curvature"] as? Double ?? curvature
+    }
+    
     /// Get Curve
     /// - Not sure if 0.08 defaultEpsilon is accurate enough when we create the curve.
     
@@ -76,6 +76,7 @@ import ReactiveSwift
     
     /// UPDATE: If I still understand correctly, this is all the state that is used inside the tapTogglers, to decide if an eventTap should be enabled or not.
     /// NOTE: Some (most?, all?) of these are somwhat of unnecessary to store here separately. E.g. `someDeviceHasScroll` can just be read from the DeviceManager. However it helps me think about the complicated logic, to gather all the relevant state here.
+    /// NOTE: Don't assign these directly. Use `update(_:_:_:)` so the change is recorded and the right togglers run. See 'Dependency tracking'.
     
     /// Derived from: Attached Devices
     
@@ -116,6 +117,80 @@ import ReactiveSwift
     private var buttonKillSwitch = false
     private var scrollKillSwitch = false
     
+    ///
+    /// Dependency tracking
+    ///
+    
+    /// Why:
+    /// - We used to call all the tap togglers after every change of the base state, even if none of the state they look at had changed. The modifiers change on every keyboard modifier press and every button press (when buttons are used as modifiers), and each toggler call goes down into the eventTap APIs and logs stuff. Most of the time, nothing actually needs to change.
+    /// - Also, whenever remaps or attached devices changed, we scanned the whole remaps dict 3 times.
+    /// How:
+    /// - Each group of derived state is a `Dependency`. When a base callback updates derived state through `update(_:_:_:)`, the dependency is only marked as changed if the value actually changed.
+    /// - Each toggler declares which dependencies it reads (see `TogglerDependencies`). `runTogglers()` then only calls the togglers whose dependencies changed.
+    /// - The remaps are compiled into a `RemapsIndex` once when they change. The index stores the smallest modified button number instead of a Bool, so when the attached devices change, we can answer 'does this modify a button on some device' without looking at the remaps again.
+    /// Notes:
+    /// - The togglers are pure functions of the derived state. (Other than `togglePointingTap()` which also reads the modifications - that's what the `.modifications` dependency is for.) So skipping a toggler whose inputs didn't change has the same effect as calling it again.
+    /// - On the first `runTogglers()` we call all togglers, since nothing has been switched on or off yet.
+    
+    struct Dependency: OptionSet {
+        let rawValue: Int
+        static let lockdown                 = Dependency(rawValue: 1 << 0)
+        static let userActive               = Dependency(rawValue: 1 << 1)
+        static let killSwitches             = Dependency(rawValue: 1 << 2)
+        static let attachedDevices          = Dependency(rawValue: 1 << 3) /// `someDeviceHas...`
+        static let remapsUsage              = Dependency(rawValue: 1 << 4) /// `somekbModModifies...`, `someButtonModifies...`, `defaultModifiesButtonOnSomeDevice`
+        static let defaultModifiesScroll    = Dependency(rawValue: 1 << 5)
+        static let currentModification      = Dependency(rawValue: 1 << 6) /// `currentModificationModifies...`
+        static let modifications            = Dependency(rawValue: 1 << 7) /// Identity of `latestModifications`
+        static let all                      = Dependency(rawValue: ~0)
+    }
+    
+    private enum TogglerDependencies {
+        static let kbModTap: Dependency = [.lockdown, .userActive, .killSwitches, .attachedDevices, .remapsUsage, .defaultModifiesScroll]
+        static let btnModProcessing: Dependency = [.killSwitches, .attachedDevices, .remapsUsage, .defaultModifiesScroll]
+        static let scrollTap: Dependency = [.lockdown, .userActive, .killSwitches, .attachedDevices, .defaultModifiesScroll, .currentModification]
+        static let buttonTap: Dependency = [.lockdown, .userActive, .killSwitches, .attachedDevices, .remapsUsage, .currentModification]
+        static let pointingTap: Dependency = [.lockdown, .userActive, .attachedDevices, .currentModification, .modifications]
+        static let killSwitchMenuItems: Dependency = [.lockdown, .attachedDevices, .remapsUsage, .defaultModifiesScroll]
+    }
+    
+    private var changedDependencies: Dependency = []
+    private var didRunTogglers = false
+    
+    @inline(__always) private func update<T: Equatable>(_ property: inout T, _ newValue: T, _ dependency: Dependency) {
+        if property != newValue {
+            property = newValue
+            changedDependencies.insert(dependency)
+        }
+    }
+    
+    private func runTogglers(reason: String, pointingModifications: NSDictionary?) {
+        
+        /// Calls the togglers whose dependencies changed since the last call.
+        /// `pointingModifications` is passed through to `togglePointingTap()`. See the notes in `remapsChanged()` for why we sometimes pass nil.
+        
+        /// Get & reset changes
+        let changed = didRunTogglers ? changedDependencies : .all
+        changedDependencies = []
+        didRunTogglers = true
+        
+        /// Skip
+        if changed.isEmpty { return }
+        
+        /// Call togglers
+        ///     Same order that we used to call them in.
+        if changed.intersects(TogglerDependencies.kbModTap)             { toggleKbModTap() }
+        if changed.intersects(TogglerDependencies.btnModProcessing)     { toggleBtnModProcessing() }
+        if changed.intersects(TogglerDependencies.scrollTap)            { toggleScrollTap() }
+        if changed.intersects(TogglerDependencies.buttonTap)            { toggleButtonTap() }
+        if changed.intersects(TogglerDependencies.pointingTap)          { togglePointingTap(modifications: pointingModifications) }
+        if changed.intersects(TogglerDependencies.killSwitchMenuItems)  { toggleKillSwitchMenuItems() }
+        
+        /// Debug
+        DDLogDebug("SwitchMaster toggling due to \(reason)")
+        logState()
+    }
+    
     
     //
     // MARK: Init
@@ -142,22 +217,15 @@ import ReactiveSwift
     @objc func lockDown() {
         
         /// Update state
-        isLockedDown = true
+        update(&isLockedDown, true, .lockdown)
+        MFSharedStatusUpdate { $0.pointee.helperIsLockedDown = 1 }
         
         /// Call togglers
         /// Notes:
         /// - Calling`toggleBtnModProcessing()` is unnecessary since we already turn off all button inputs in  `toggleButtonTap()`
         /// - Not sure if we need to call `togglePointingTap(modifications:)`
         
-        toggleKbModTap()
-        toggleScrollTap()
-        toggleButtonTap()
-        togglePointingTap(modifications: nil)
-        toggleKillSwitchMenuItems()
-        
-        /// Debug
-        DDLogDebug("SwitchMaster toggling due to lockdown")
-        logState()
+        runTogglers(reason: "lockdown", pointingModifications: nil)
     }
     
     //
@@ -170,23 +238,11 @@ import ReactiveSwift
         /// - On listening to activeDevice
         ///     - This would let us turn off buttonTap / scrollTap for mice that don't support buttons / don't support scrolling. However then we couldn't update the active device when another mouse sends scroll or button input because we wouldn't be listening to that input. So it's better to just listen to all attachedDevices.
         
-        let userIsActiveNew = HelperState.shared.userIsActive
+        /// Update State
+        update(&userIsActive, HelperState.shared.userIsActive, .userActive)
         
-        if userIsActiveNew != userIsActive {
-            
-            /// Update State
-            userIsActive = userIsActiveNew
-            
-            /// Call togglers
-            toggleKbModTap()
-            toggleScrollTap()
-            toggleButtonTap()
-            togglePointingTap(modifications: nil)
-            
-            /// Debug
-            DDLogDebug("SwitchMaster toggling due to helperState change")
-            logState()
-        }
+        /// Call togglers
+        runTogglers(reason: "helperState change", pointingModifications: nil)
     }
     
     //
@@ -200,30 +256,11 @@ import ReactiveSwift
         let scrl = generalConfig.object(forKey: "scrollKillSwitch") as! Bool
         
         /// Store & record change
+        update(&buttonKillSwitch, btn, .killSwitches)
+        update(&scrollKillSwitch, scrl, .killSwitches)
         
-        var didChange = false
-        
-        if btn != buttonKillSwitch {
-            buttonKillSwitch = btn
-            didChange = true
-        }
-        if scrl != scrollKillSwitch {
-            scrollKillSwitch = scrl
-            didChange = true
-        }
-        
-        if didChange {
-            
-            /// Call togglers
-            toggleKbModTap()
-            toggleScrollTap()
-            toggleButtonTap()
-            togglePointingTap(modifications: nil)
-            
-            /// Debug
-            DDLogDebug("SwitchMaster toggling due to killSwitch change")
-            logState()
-        }
+        /// Call togglers
+        runTogglers(reason: "killSwitch change", pointingModifications: nil)
     }
     
     //
@@ -234,60 +271,45 @@ import ReactiveSwift
     @objc func attachedDevicesChanged(devices: NSArray) {
         
         /// Update state
-        self.someDeviceHasScroll = DeviceManager.someDeviceHasScrollWheel()
-        self.someDeviceHasPointing = DeviceManager.someDeviceHasPointing()
-        self.someDeviceHasUsableButtons = DeviceManager.someDeviceHasUsableButtons()
-        self.maxButtonNumberAmongDevices = DeviceManager.maxButtonNumberAmongDevices()
+        update(&someDeviceHasScroll, DeviceManager.someDeviceHasScrollWheel(), .attachedDevices)
+        update(&someDeviceHasPointing, DeviceManager.someDeviceHasPointing(), .attachedDevices)
+        update(&someDeviceHasUsableButtons, DeviceManager.someDeviceHasUsableButtons(), .attachedDevices)
+        update(&maxButtonNumberAmongDevices, DeviceManager.maxButtonNumberAmongDevices(), .attachedDevices)
         
         /// Call combined state updaters
-        remapsOrAttachedDevicesChanged(remaps: latestRemaps, devices: devices)
-        remapsOrModifiersOrAttachedDevicesChanged(remaps: latestRemaps, modifiers: latestModifiers, attachedDevices: devices)
+        remapsOrAttachedDevicesChanged()
+        remapsOrModifiersOrAttachedDevicesChanged()
         
         /// Store
         latestDevices = devices
         
         /// Call togglers
-        self.toggleKbModTap()
-        self.toggleBtnModProcessing()
-        
-        self.toggleScrollTap()
-        self.toggleButtonTap()
-        self.togglePointingTap(modifications: nil)
-        toggleKillSwitchMenuItems()
-        
-        /// Debug
-        DDLogDebug("SwitchMaster toggling due to attachedDevices change")
-        logState()
-        
+        runTogglers(reason: "attachedDevices change", pointingModifications: nil)
     }
     
     private var latestRemaps = NSDictionary()
+    private var remapsIndex = RemapsIndex()
     @objc func remapsChanged(remaps: NSDictionary) {
         
+        /// Compile index
+        remapsIndex = RemapsIndex(remaps: remaps, addModeIsEnabled: Remap.addModeIsEnabled)
+        
         /// Update state
-        let result = self.modifierUsage_Point_Scroll(remaps)
-        self.somekbModModifiesPointing = result.someKbModModifiesPointing
-        self.somekbModModifiesScroll = result.someKbModModifiesScroll
-        self.someButtonModifiesPointing = result.someButtonModifiesPointing
-        self.someButtonModifiesScroll = result.someButtonModifiesScroll
+        update(&somekbModModifiesPointing, remapsIndex.kbModModifiesPointing, .remapsUsage)
+        update(&somekbModModifiesScroll, remapsIndex.kbModModifiesScroll, .remapsUsage)
+        update(&someButtonModifiesPointing, remapsIndex.buttonModifiesPointing, .remapsUsage)
+        update(&someButtonModifiesScroll, remapsIndex.buttonModifiesScroll, .remapsUsage)
         
         /// Call combined state updaters
-        remapsOrAttachedDevicesChanged(remaps: remaps, devices: latestDevices)
-        remapsOrModifiersChanged(remaps: remaps, modifiers: latestModifiers)
-        remapsOrModifiersOrAttachedDevicesChanged(remaps: remaps, modifiers: latestModifiers, attachedDevices: latestDevices)
+        remapsOrAttachedDevicesChanged()
+        remapsOrModifiersChanged(modifiers: latestModifiers)
+        remapsOrModifiersOrAttachedDevicesChanged()
         
         /// Store
         latestRemaps = remaps
         
         /// Call togglers
-        self.toggleKbModTap()
-        self.toggleBtnModProcessing()
-        
-        self.toggleScrollTap()
-        self.toggleButtonTap()
-        
-        toggleKillSwitchMenuItems()
-        
+        ///
         /// On not toggling pointing tap
         /// - Would be a hack
         /// - We want to do this because it prevents an issue where after recording a click and drag in the addField it immediately activates.
@@ -296,11 +318,7 @@ import ReactiveSwift
         ///     - sol2:Make modifiedDrag ignore reinitialization while addModeDrag is active
         /// - On passing in self.latestModifications:
         ///  -  I'm not 100% sure self.latestModifications is always up-to-date here (what if the new remaps should enable modifier tracking but those modifiers aren't in self.latestModifications, yet?). Since this is not performance-critical it's better to just pass in nil, so that `togglePointingTap()` gets the values fresh.
-        self.togglePointingTap(modifications: nil /*self.latestModifications*/)
-        
-        /// Debug
-        DDLogDebug("SwitchMaster toggling due to remaps change")
-        logState()
+        runTogglers(reason: "remaps change", pointingModifications: nil /*self.latestModifications*/)
     }
     
     private var latestScrollConfig = ScrollConfig.shared /// Not sure if this is a good initialization value
@@ -309,91 +327,82 @@ import ReactiveSwift
         /// Update state
         if Remap.addModeIsEnabled {
             /// This doesn't work because scrollConfig doesn't change for addMode, so we don't get a callback. We instead solved this in `concludeAddModeWithPayload:`
-            self.defaultModifiesScroll = false
+            update(&defaultModifiesScroll, false, .defaultModifiesScroll)
         } else {
-            self.defaultModifiesScroll = /*!scrollKillSwitch && */
-            (scrollConfig.smoothEnabled || scrollConfig.u_speed != kMFScrollSpeedSystem || scrollConfig.u_invertDirection == kMFScrollInversionInverted)
+            update(&defaultModifiesScroll, /*!scrollKillSwitch && */
+                   (scrollConfig.smoothEnabled || scrollConfig.u_speed != kMFScrollSpeedSystem || scrollConfig.u_invertDirection == kMFScrollInversionInverted),
+                   .defaultModifiesScroll)
         }
         
         /// Store
         latestScrollConfig = scrollConfig
         
         /// Call togglers
-        self.toggleKbModTap()
-        self.toggleBtnModProcessing()
-        
-        self.toggleScrollTap()
-        
-        toggleKillSwitchMenuItems()
-        
-        /// Debug
-        DDLogDebug("SwitchMaster toggling due to scroll config change")
-        logState()
+        runTogglers(reason: "scroll config change", pointingModifications: nil)
     }
     
     private var latestModifiers = NSDictionary()
     @objc func modifiersChanged(modifiers: NSDictionary) {
         
+        /// NOTE: This is called on every modifier change, so it needs to be fast!
+        
         /// Call combined state updaters
-        remapsOrModifiersChanged(remaps: latestRemaps, modifiers: modifiers)
-        remapsOrModifiersOrAttachedDevicesChanged(remaps: latestRemaps, modifiers: modifiers, attachedDevices: latestDevices)
+        remapsOrModifiersChanged(modifiers: modifiers)
+        remapsOrModifiersOrAttachedDevicesChanged()
         
         /// Store
         latestModifiers = modifiers
         
         /// Call togglers
-        
-        self.toggleScrollTap()
-        self.toggleButtonTap()
-        self.togglePointingTap(modifications: self.latestModifications)
-        
-        /// Debug
-        DDLogDebug("SwitchMaster toggling due to modifier change")
-        logState()
+        runTogglers(reason: "modifier change", pointingModifications: self.latestModifications)
     }
     
     //
     // MARK: Combined callbacks
     //
     
-    private func remapsOrAttachedDevicesChanged(remaps: NSDictionary, devices: NSArray) {
+    private func remapsOrAttachedDevicesChanged() {
         
-        let maxButton = DeviceManager.maxButtonNumberAmongDevices()
-        let result = self.modifierUsage_Buttons(remaps, maxButton: maxButton)
-        self.somekbModModifiesButtonOnSomeDevice = result.somekbModModifiesButtonOnSomeDevice
-        self.someButtonModifiesButtonOnSomeDevice = result.someButtonModifiesButtonOnSomeDevice
+        /// Answered from the index, so we don't need to look at the remaps here
         
-        self.defaultModifiesButtonOnSomeDevice = self.defaultModifiesButtonOnSomeDevice(remaps, maxButton: maxButton)
+        let maxButton = Int(maxButtonNumberAmongDevices)
+        update(&somekbModModifiesButtonOnSomeDevice, remapsIndex.minButtonModifiedWithKbMod <= maxButton, .remapsUsage)
+        update(&someButtonModifiesButtonOnSomeDevice, remapsIndex.minButtonModifiedWithButtonMod <= maxButton, .remapsUsage)
+        update(&defaultModifiesButtonOnSomeDevice, remapsIndex.minButtonModifiedByDefault <= maxButton, .remapsUsage)
     }
     
     private var latestModifications: NSDictionary? = nil
-    private func remapsOrModifiersChanged(remaps: NSDictionary, modifiers: NSDictionary) {
+    private func remapsOrModifiersChanged(modifiers: NSDictionary) {
         
         /// Derive modifications
+        ///     `Remap` caches the modifications for each modifier state, so we usually get the same object for the same modifiers.
         let modifications = Remap.modifications(withModifiers: modifiers)
         
         /// Update state
         if let m = modifications {
-            self.currentModificationModifiesScroll = RemapsAnalyzer.modificationsModifyScroll(m)
-            self.currentModificationModifiesPointing = RemapsAnalyzer.modificationsModifyPointing(m)
+            update(&currentModificationModifiesScroll, RemapsAnalyzer.modificationsModifyScroll(m), .currentModification)
+            update(&currentModificationModifiesPointing, RemapsAnalyzer.modificationsModifyPointing(m), .currentModification)
         } else {
-            self.currentModificationModifiesScroll = false
-            self.currentModificationModifiesPointing = false
+            update(&currentModificationModifiesScroll, false, .currentModification)
+            update(&currentModificationModifiesPointing, false, .currentModification)
         }
         
         /// Store
-        latestModifications = modifications
+        if modifications !== latestModifications {
+            latestModifications = modifications
+            changedDependencies.insert(.modifications)
+        }
     }
     
-    private func remapsOrModifiersOrAttachedDevicesChanged(remaps: NSDictionary, modifiers: NSDictionary, attachedDevices: NSArray) {
+    private func remapsOrModifiersOrAttachedDevicesChanged() {
         
         /// NOTE: Not totally sure using `latestModifications` always works here. Make sure you call `remapsOrModifiersChanged` before this so `latestModifications` is updated first
         
         /// Update state
         if let m = latestModifications {
-            self.currentModificationModifiesButtonOnSomeDevice = RemapsAnalyzer.modificationsModifyButtons(m, maxButton: DeviceManager.maxButtonNumberAmongDevices())
+            update(&currentModificationModifiesButtonOnSomeDevice, RemapsAnalyzer.modificationsModifyButtons(m, maxButton: maxButtonNumberAmongDevices), .currentModification)
         } else {
-            self.currentModificationModifiesButtonOnSomeDevice = false
+            update(&currentModificationModifiesButtonOnSomeDevice, false, .currentModification)
         }
 
     }
@@ -611,131 +620,89 @@ import ReactiveSwift
     
     /// Remaps analysis
     
-    fileprivate func modifierUsage_Buttons(_ remaps: NSDictionary?, maxButton: Int32) -> (somekbModModifiesButtonOnSomeDevice: Bool,
-                                                                                          someButtonModifiesButtonOnSomeDevice: Bool) {
+    fileprivate struct RemapsIndex {
+        
+        /// Everything SwitchMaster needs to know about the remaps, gathered in a single pass when the remaps change.
+        ///
+        /// Notes:
+        /// - For buttons, we store the smallest button number that is modified, instead of 'modifies a button on some device'. That way the index stays valid when the attached devices change. `minButton <= maxButtonNumberAmongDevices` gives the same result as `RemapsAnalyzer.modificationsModifyButtons()`.
+        /// - In addMode, we hardcode some values. See below.
         
-        var kbModSways = false
-        var btnSways = false
+        var kbModModifiesScroll = false
+        var kbModModifiesPointing = false
+        var buttonModifiesScroll = false
+        var buttonModifiesPointing = false
         
-        if Remap.addModeIsEnabled {
-            kbModSways = true
-            btnSways = true
-        } else {
+        var minButtonModifiedWithKbMod = Int.max        /// Smallest button modified by a modification that has a keyboard modifier precondition
+        var minButtonModifiedWithButtonMod = Int.max    /// Smallest button modified by a modification that has a button modifier precondition
+        var minButtonModifiedByDefault = Int.max        /// Smallest button modified by the default (unmodified) modification
+        
+        init() {}
+        
+        init(remaps: NSDictionary, addModeIsEnabled: Bool) {
+            
+            /// Default modification
+            ///     (We used to evaluate this independent of addMode, so we still do)
+            if let defaultModification = remaps.object(forKey: NSDictionary()) as? NSDictionary {
+                minButtonModifiedByDefault = RemapsIndex.minButton(defaultModification)
+            }
             
-            remaps?.enumerateKeysAndObjects(options: [/*.concurrent*/]) { modifiers, modifications, stop in
+            if addModeIsEnabled {
                 
-                var keyboard = false
-                var button = false
+                /// On setting kbMod pointing and scroll to false:
+                /// Setting kbMod stuff to false because we don't allow recording scroll and drag triggers  in addMode without a button as a modifier.
+                ///     Just setting this stuff to false should prevent this but it's not semantic because `someKbModModifiesPointing` and `someKbModModifiesScroll` (which we're setting false here) are technically true. Probably a better way to implement the "there needs to be a button" restriction in `concludeAddModeWithPayload:`.
+                ///     Edit: Implemented the stuff in `concludeAddModeWithPayload:` so this should be unnecessary, but it also shouldn't hurt.
                 
-                if !kbModSways {
-                    keyboard = (modifiers as! NSDictionary).object(forKey: kMFModificationPreconditionKeyKeyboard) != nil
-                }
-                if !btnSways {
-                    button = (modifiers as! NSDictionary).object(forKey: kMFModificationPreconditionKeyButtons) != nil
-                }
+                kbModModifiesPointing = false
+                kbModModifiesScroll = false
+                buttonModifiesPointing = true
+                buttonModifiesScroll = true
                 
-                if keyboard || button {
-                    
-                    if (!kbModSways && keyboard) || (!btnSways && button) {
-                        var doesModify = false
-                        if let m = modifications as? NSDictionary {
-                            doesModify = RemapsAnalyzer.modificationsModifyButtons(m, maxButton: maxButton)
-                        }
-                        if doesModify {
-                            if !kbModSways { kbModSways = keyboard }
-                            if !btnSways { btnSways = button }
-                        }
-                    }
-                }
+                /// All buttons need to be intercepted in addMode
+                minButtonModifiedWithKbMod = Int.min
+                minButtonModifiedWithButtonMod = Int.min
                 
-                if kbModSways && btnSways {
-                    stop.pointee = ObjCBool.init(true)
-                }
+                return
             }
-        }
-        
-        return (somekbModModifiesButtonOnSomeDevice: kbModSways, someButtonModifiesButtonOnSomeDevice: btnSways)
-    }
-    
-    fileprivate func defaultModifiesButtonOnSomeDevice(_ remaps: NSDictionary, maxButton: Int32) -> Bool {
-        
-        var defaultSways = false
-        
-        let empty = NSDictionary()
-        if let defaultModification = remaps.object(forKey: empty) as? NSDictionary {
-            defaultSways = RemapsAnalyzer.modificationsModifyButtons(defaultModification, maxButton: maxButton)
-        }
-        
-        return defaultSways
-    }
-    
-    fileprivate func modifierUsage_Point_Scroll(_ remaps: NSDictionary) -> (someKbModModifiesPointing: Bool, someKbModModifiesScroll: Bool, someButtonModifiesPointing: Bool, someButtonModifiesScroll: Bool) {
-        
-        var kbSwayPoint = false
-        var kbSwayScroll = false
-        var btnSwayPoint = false
-        var btnSwayScroll = false
-        
-        if Remap.addModeIsEnabled {
             
-            /// On setting `kbSwayPoint` and `kbSwayScroll` to false:
-            /// Setting kbMod stuff to false because we don't allow recording scroll and drag triggers  in addMode without a button as a modifier.
-            ///     Just setting this stuff to false should prevent this but it's not semantic because `someKbModModifiesPointing` and `someKbModModifiesScroll` (which we're setting false here) are technically true. Probably a better way to implement the "there needs to be a button" restriction in `concludeAddModeWithPayload:`.
-            ///     Edit: Implemented the stuff in `concludeAddModeWithPayload:` so this should be unnecessary, but it also shouldn't hurt.
-            
-            kbSwayPoint = false
-            kbSwayScroll = false
-            btnSwayPoint = true
-            btnSwayScroll = true
-            
-        } else {
-            
-            remaps.enumerateKeysAndObjects(options: [/*.concurrent*/]) { modifiers, modification, stop in
+            for (modifiers, modification) in remaps {
                 
-                /// Notes:
-                ///  - `.concurrent` option should make things slower for small arrays. See https://darkdust.net/writings/objective-c/nsarray-enumeration-performance
-                ///   - All these if statements totally overcomplicate things. It's what I call "Premature Boptimization"
-                ///   - Notice how we made it even faster by first looking at the modifers and then looking at the modification because the modifiers have less keys usually.
-                ///   - This only happens when the remaps change, and we should just cache this if it's slow. There is no reason whatsoever to make this so fast and unreadable.
-                ///   - Just using a for...in loop on the dict also gives you the keys and values in Swift, so using `enumerateKeysAndObjects` is probably not the best idea since it might be slower than a simple loop.
+                guard let modifiers = modifiers as? NSDictionary, let modification = modification as? NSDictionary else { continue }
                 
-                var keyboard = false
-                var button = false
+                let keyboard = modifiers.object(forKey: kMFModificationPreconditionKeyKeyboard) != nil
+                let button = modifiers.object(forKey: kMFModificationPreconditionKeyButtons) != nil
+                if !keyboard && !button { continue }
                 
-                if !kbSwayPoint || !kbSwayScroll {
-                    keyboard = (modifiers as! NSDictionary).object(forKey: kMFModificationPreconditionKeyKeyboard) != nil
-                }
-                if !btnSwayPoint || !btnSwayScroll {
-                    button = (modifiers as! NSDictionary).object(forKey: kMFModificationPreconditionKeyButtons) != nil
-                }
+                let scroll = RemapsAnalyzer.modificationsModifyScroll(modification)
+                let point = RemapsAnalyzer.modificationsModifyPointing(modification)
+                let minButton = RemapsIndex.minButton(modification)
                 
-                if keyboard || button {
-                    
-                    if (!kbSwayPoint && keyboard) || (!btnSwayPoint && button) {
-                        var point = false
-                        if let m = modification as? NSDictionary {
-                            point = RemapsAnalyzer.modificationsModifyPointing(m)
-                        }
-                        if !btnSwayPoint { btnSwayPoint = button && point }
-                        if !kbSwayPoint { kbSwayPoint = keyboard && point }
-                    }
-                    if (!kbSwayScroll && keyboard) || (!btnSwayScroll && button) {
-                        var scroll = false
-                        if let m = modification as? NSDictionary {
-                            scroll = RemapsAnalyzer.modificationsModifyScroll(m)
-                        }
-                        if !btnSwayScroll { btnSwayScroll = button && scroll }
-                        if !kbSwayScroll { kbSwayScroll = keyboard && scroll }
-                    }
+                if keyboard {
+                    kbModModifiesScroll = kbModModifiesScroll || scroll
+                    kbModModifiesPointing = kbModModifiesPointing || point
+                    minButtonModifiedWithKbMod = min(minButtonModifiedWithKbMod, minButton)
                 }
-                
-                if kbSwayScroll && kbSwayPoint && btnSwayScroll && btnSwayPoint {
-                    stop.pointee = ObjCBool.init(true)
+                if button {
+                    buttonModifiesScroll = buttonModifiesScroll || scroll
+                    buttonModifiesPointing = buttonModifiesPointing || point
+                    minButtonModifiedWithButtonMod = min(minButtonModifiedWithButtonMod, minButton)
                 }
             }
         }
         
-        return (someKbModModifiesPointing: kbSwayPoint, someKbModModifiesScroll: kbSwayScroll, someButtonModifiesPointing: btnSwayPoint, someButtonModifiesScroll: btnSwayScroll)
+        private static func minButton(_ modification: NSDictionary) -> Int {
+            
+            /// Button triggers are the NSNumber keys of the modification. Other triggers (scroll, drag) are strings.
+            
+            var result = Int.max
+            for key in modification.allKeys {
+                if let button = key as? NSNumber {
+                    result = min(result, button.intValue)
+                }
+            }
+            return result
+        }
     }
 }
 
@@ -50,6 +50,8 @@ typedef enum {
 + (NSDictionary *)modifiersWithEvent:(CGEventRef _Nullable)event MF_SWIFT_HIDDEN;
 + (id)__SWIFT_UNBRIDGED_modifiersWithEvent:(CGEventRef _Nullable)event;
 
++ (NSUInteger)keyboardModifierFlagsWithEvent:(CGEventRef _Nullable)event;
+
 + (void)buttonModsChangedTo:(ButtonModifierState)newModifiers;
 + (void)__SWIFT_UNBRIDGED_buttonModsChangedTo:(id)newModifiers;
 
@@ -16,6 +16,7 @@
 #import "DeviceManager.h"
 #import "SharedUtility.h"
 #import "ModificationUtility.h"
+#import "MFSharedStatus.h"
 #import <os/signpost.h>
 #import "Mac_Mouse_Fix_Helper-Swift.h"
 
@@ -154,6 +155,9 @@ CGEventRef _Nullable kbModsChanged(CGEventTapProxy proxy, CGEventType type, CGEv
             _modifiers[kMFModificationPreconditionKeyKeyboard] = newFlagsNS;
         }
         
+        /// Publish for mainApp
+        MFSharedStatusUpdate(^(MFSharedStatus *status) { status->keyboardModifierFlags = newFlags; });
+        
         /// Notify
 //        [ReactiveModifiers.shared handleModifiersDidChangeTo:_modifiers];
         [SwitchMaster.shared modifiersChangedWithModifiers:_modifiers];
@@ -262,6 +266,13 @@ static NSUInteger flagsFromEvent(CGEventRef _Nullable event) {
     return [self modifiersWithEvent:event];
 }
 
++ (NSUInteger)keyboardModifierFlagsWithEvent:(CGEventRef _Nullable)event {
+    
+    /// Just the keyboard flags, masked the same way as in the modifiers dict. Doesn't touch any shared state, so it's safe to call from any thread.
+    
+    return flagsFromEvent(event);
+}
+
 #pragma mark Handle mod usage
 
 + (void)handleModificationHasBeenUsed {
@@ -19,6 +19,7 @@
 #import "Constants.h"
 #import "Config.h"
 #import "MFMessagePort.h"
+#import "MFSharedStatus.h"
 #import "Mac_Mouse_Fix_Helper-Swift.h"
 #import "RemapSwizzler.h"
 
@@ -129,6 +130,7 @@ static NSDictionary *_remaps;
     
     if (_addModeIsEnabled) {
         _addModeIsEnabled = NO;
+        MFSharedStatusUpdate(^(MFSharedStatus *status) { status->addModeIsEnabled = false; });
 //        [MFMessagePort sendMessage:@"addModeDisabled" withPayload:nil expectingReply:NO];
     }
     
@@ -329,6 +331,7 @@ BOOL _addModeIsEnabled = NO;
     /// Update state and notifiy
     ///     Need to set `_addModeIsEnabled` true before calling `setRemaps:` so that the keyboard mods event tap in `Modifiers` is toggled properly
     _addModeIsEnabled = YES;
+    MFSharedStatusUpdate(^(MFSharedStatus *status) { status->addModeIsEnabled = true; });
     
     /// Send feedback
 //    [MFMessagePort sendMessage:@"addModeEnabled" withPayload:nil expectingReply:NO];
@@ -388,7 +391,9 @@ BOOL _addModeIsEnabled = NO;
     
     
     
-    [MFMessagePort sendMessage:@"addModeFeedback" withPayload:payload waitForReply:NO];
+    if (!MFSharedStatusPushFeedback(@"addModeFeedback", payload)) { /// Fall back to the message port if the shared memory ring is unavailable or full
+        [MFMessagePort sendMessage:@"addModeFeedback" withPayload:payload waitForReply:NO];
+    }
     ///    [Remap performSelector:@selector(disableAddMode) withObject:nil afterDelay:0.5];
     /// ^ We did this to keep the remapping disabled for a little while after adding a new row, but it leads to adding several entries at once when trying to input button modification precondition, if you're not fast enough.
 
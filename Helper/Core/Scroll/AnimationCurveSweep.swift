@@ -0,0 +1,244 @@
+//
+// --------------------------------------------------------------------------
+// AnimationCurveSweep.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Tool for tuning the `MFScrollAnimationCurveParameters` presets in `ScrollConfig > animationCurveParamsMap(name:)`
+///
+/// __Why__
+/// - So far we tuned the presets by hand: Change a value, rebuild, scroll around, repeat. That's slow and it's hard to compare more than 2 or 3 candidates.
+/// - This lets you build thousands of candidate curves over a parameter grid, play a tick trace through each of them with a virtual frame clock, and compare them by a few numbers.
+///
+/// __How__
+/// - The simulation mirrors what Scroll.m does when it starts the animator: On every tick, the distance that the running animation still wants to scroll is added to the distance of the new tick, and a new `BezierHybridCurve` is created for the combined distance. If `speedSmoothing` is used, the baseCurve is created from the current animation speed, just like in Scroll.m.
+/// - We don't go through the real `TouchAnimator` / `DisplayLink` and we don't send any events. Frames are just timestamps spaced `frameInterval` apart.
+/// - Candidates are independent, so we evaluate them with `DispatchQueue.concurrentPerform`, which lets GCD spread the work over all cores.
+///
+/// __Usage__
+/// - Call `AnimationCurveSweep.run()` from the debugger (`po AnimationCurveSweep.run()`) or temporarily from `applicationDidFinishLaunching` or similar. It logs a table of the best candidates.
+/// - Ticks recorded from ScrollAnalyzer logs can be passed in via `TickTrace(times:deltas:)`
+///
+/// __Notes__
+/// - The metrics:
+///     - `timeTo90Percent`: Seconds from the first tick until 90% of the total input distance has been scrolled. Lower feels more responsive.
+///     - `peakSpeed`: Highest px/s between two frames.
+///     - `maxJerk`: Largest change in per-frame speed between two consecutive frames (px/s per frame). Lower feels smoother. Spikes usually come from a new tick 'restarting' the animation at a different speed.
+///     - `overshoot`: How many px the simulated scroll position went beyond the total input distance. Should always be ~0 for HybridCurves, if it's not, something is broken.
+/// - `BezierHybridCurve` logs a bunch of debug messages for each curve it creates. You might want to turn down the log level before running large sweeps.
+/// - The whole file is `#if DEBUG`, so the sweep doesn't ship in release builds.
+
+#if DEBUG
+
+import Cocoa
+import CocoaLumberjackSwift
+
+@objc class AnimationCurveSweep: NSObject {
+
+    // MARK: Types
+
+    struct TickTrace {
+        let times: [Double]     /// Timestamps of the scrollwheel ticks in seconds. Ascending.
+        let deltas: [Double]    /// px scrolled by each tick (after acceleration)
+
+        init(times: [Double], deltas: [Double]) {
+            assert(times.count == deltas.count)
+            self.times = times
+            self.deltas = deltas
+        }
+
+        static func swipe(ticks: Int, interval: Double, pxPerTick: Double) -> TickTrace {
+            /// Evenly spaced ticks. Good enough to compare candidates for a 'typical' swipe.
+            return TickTrace(times: (0..<ticks).map { Double($0) * interval },
+                             deltas: Array(repeating: pxPerTick, count: ticks))
+        }
+    }
+
+    struct Candidate {
+        let speedSmoothing: Double  /// -1 means use `ScrollConfig.linearCurve` as the baseCurve
+        let baseMsPerStep: Int
+        let dragCoefficient: Double
+        let dragExponent: Double
+        let stopSpeed: Int
+    }
+
+    struct Metrics {
+        var timeTo90Percent: Double = .infinity
+        var peakSpeed: Double = 0
+        var maxJerk: Double = 0
+        var overshoot: Double = 0
+    }
+
+    struct Result {
+        let candidate: Candidate
+        let metrics: Metrics
+    }
+
+    // MARK: Interface
+
+    @objc static func run() {
+
+        /// Sweep around the values of the current `highInertia`/`smooth` presets and log the best candidates.
+        ///     Adjust the grids and traces to whatever you want to tune.
+
+        let traces: [TickTrace] = [
+            .swipe(ticks: 1, interval: 0.0, pxPerTick: 60),
+            .swipe(ticks: 6, interval: 0.06, pxPerTick: 60),
+            .swipe(ticks: 20, interval: 0.025, pxPerTick: 120),
+        ]
+
+        let candidates = grid(speedSmoothing:  [-1, 0.0, 0.15, 0.3],
+                              baseMsPerStep:   [120, 140, 160, 175, 200],
+                              dragCoefficient: [15, 20, 23, 25, 30, 40],
+                              dragExponent:    [0.8, 0.9, 1.0, 1.05, 1.2],
+                              stopSpeed:       [30, 50])
+
+        let startTime = CACurrentMediaTime()
+        let results = sweep(candidates: candidates, traces: traces)
+        let runTime = CACurrentMediaTime() - startTime
+
+        /// Rank
+        ///     Just a simple score for sorting. Responsiveness and smoothness pull in opposite directions, so look at the raw columns, too.
+        let ranked = results.sorted { score($0.metrics) < score($1.metrics) }
+
+        /// Log
+        var table = "AnimationCurveSweep - evaluated \(candidates.count) candidates on \(traces.count) traces in \(String(format: "%.2f", runTime))s\n"
+        table += "smooth  ms   dragC  dragE  stop | t90(ms)  peak(px/s)  jerk    overshoot\n"
+        for r in ranked.prefix(30) {
+            let c = r.candidate, m = r.metrics
+            table += String(format: "%5.2f  %4d  %5.1f  %5.2f  %4d | %7.1f  %10.1f  %7.1f  %6.2f\n", c.speedSmoothing, c.baseMsPerStep, c.dragCoefficient, c.dragExponent, c.stopSpeed, m.timeTo90Percent*1000, m.peakSpeed, m.maxJerk, m.overshoot)
+        }
+        DDLogInfo("\(table)")
+    }
+
+    static func grid(speedSmoothing: [Double], baseMsPerStep: [Int], dragCoefficient: [Double], dragExponent: [Double], stopSpeed: [Int]) -> [Candidate] {
+
+        var result: [Candidate] = []
+        result.reserveCapacity(speedSmoothing.count * baseMsPerStep.count * dragCoefficient.count * dragExponent.count * stopSpeed.count)
+
+        for s in speedSmoothing { for ms in baseMsPerStep { for dc in dragCoefficient { for de in dragExponent { for ss in stopSpeed {
+            result.append(Candidate(speedSmoothing: s, baseMsPerStep: ms, dragCoefficient: dc, dragExponent: de, stopSpeed: ss))
+        }}}}}
+
+        return result
+    }
+
+    static func sweep(candidates: [Candidate], traces: [TickTrace], frameInterval: Double = 1.0/60.0) -> [Result] {
+
+        /// Evaluates all candidates on all traces concurrently. The metrics of a candidate are the worst values across the traces.
+
+        var metrics = [Metrics](repeating: Metrics(), count: candidates.count)
+
+        metrics.withUnsafeMutableBufferPointer { out in
+            let out = out /// Capture the buffer, not the array, so the workers don't trigger copy-on-write
+            DispatchQueue.concurrentPerform(iterations: candidates.count) { i in
+
+                var worst = Metrics(timeTo90Percent: 0, peakSpeed: 0, maxJerk: 0, overshoot: 0)
+                for trace in traces {
+                    let m = simulate(candidate: candidates[i], trace: trace, frameInterval: frameInterval)
+                    worst.timeTo90Percent   = max(worst.timeTo90Percent, m.timeTo90Percent)
+                    worst.peakSpeed         = max(worst.peakSpeed, m.peakSpeed)
+                    worst.maxJerk           = max(worst.maxJerk, m.maxJerk)
+                    worst.overshoot         = max(worst.overshoot, m.overshoot)
+                }
+                out[i] = worst /// Every iteration writes a different index, so this is safe
+            }
+        }
+
+        return zip(candidates, metrics).map { Result(candidate: $0, metrics: $1) }
+    }
+
+    // MARK: Simulation
+
+    static func simulate(candidate c: Candidate, trace: TickTrace, frameInterval: Double) -> Metrics {
+
+        /// Notes:
+        /// - `position` is the total distance scrolled so far. The running animation is described by its curve, start time, start position and distance.
+
+        var metrics = Metrics()
+        guard let firstTick = trace.times.first else { return metrics }
+
+        let totalInput = trace.deltas.reduce(0, +)
+        let baseDuration = Double(c.baseMsPerStep) / 1000.0
+
+        var curve: HybridCurve? = nil
+        var animationStart = 0.0
+        var animationStartPosition = 0.0
+        var animationDistance = 0.0
+
+        var position = 0.0
+        var lastSpeed = 0.0
+        var nextTick = 0
+        var time = firstTick
+
+        while true {
+
+            /// Start new animations for the ticks that arrived until this frame
+            while nextTick < trace.times.count && trace.times[nextTick] <= time {
+
+                /// Get distance the running animation still wants to scroll
+                var distanceLeft = 0.0
+                if let curve = curve {
+                    let x = min((time - animationStart) / curve.duration, 1.0)
+                    distanceLeft = animationDistance - curve.evaluate(at: x) * animationDistance
+                }
+                let delta = trace.deltas[nextTick] + distanceLeft
+
+                /// Get baseCurve
+                ///     Mirrors Scroll.m (including its units)
+                let baseCurve: Bezier
+                if c.speedSmoothing == -1 {
+                    baseCurve = ScrollConfig.linearCurve
+                } else {
+                    let direction = Vector(x: 1 / (baseDuration/1000.0), y: lastSpeed / delta)
+                    let p1 = vectorFromDeltaAndDirectionVector(c.speedSmoothing, direction)
+                    baseCurve = Bezier(controlPoints: [[0, 0], [p1.x, p1.y], [1, 1]], defaultEpsilon: 0.01)
+                }
+
+                /// Create curve
+                curve = BezierHybridCurve(baseCurve: baseCurve, minDuration: baseDuration, distance: delta, dragCoefficient: c.dragCoefficient, dragExponent: c.dragExponent, stopSpeed: Double(c.stopSpeed), distanceEpsilon: 0.2)
+                animationStart = time
+                animationStartPosition = position
+                animationDistance = delta
+
+                nextTick += 1
+            }
+
+            /// Advance frame
+            time += frameInterval
+
+            guard let curve = curve else { continue }
+            let x = min((time - animationStart) / curve.duration, 1.0)
+            let newPosition = animationStartPosition + curve.evaluate(at: x) * animationDistance
+
+            /// Update metrics
+            let speed = (newPosition - position) / frameInterval
+            metrics.peakSpeed = max(metrics.peakSpeed, speed)
+            metrics.maxJerk = max(metrics.maxJerk, abs(speed - lastSpeed))
+            metrics.overshoot = max(metrics.overshoot, newPosition - totalInput)
+            if metrics.timeTo90Percent == .infinity && newPosition >= 0.9 * totalInput {
+                metrics.timeTo90Percent = time - firstTick
+            }
+
+            position = newPosition
+            lastSpeed = speed
+
+            /// Break
+            if x >= 1.0 && nextTick >= trace.times.count { break }
+        }
+
+        return metrics
+    }
+
+    // MARK: Helper
+
+    private static func score(_ m: Metrics) -> Double {
+        /// Jerk is in px/s per frame, and timeTo90Percent is in seconds. The weights bring them to a roughly similar scale for typical values.
+        return m.timeTo90Percent * 1000 + m.maxJerk * 0.05 + m.overshoot * 10
+    }
+}
+
+#endif
@@ -27,11 +27,14 @@
 #import "ScrollModifiers.h"
 #import "Actions.h"
 #import "EventUtility.h"
+#import "EventFieldCodec.h"
+#import "ScrollTickCarry.h"
 #import "MathObjc.h"
 
 @import IOKit;
 #import "MFHIDEventImports.h"
 #import "IOUtility.h"
+#import <stdatomic.h>
 
 @implementation Scroll
 
@@ -56,6 +59,11 @@ static ScrollConfig *_scrollConfig;
 static MFScrollAnimationCurveParameters *_animationParams;
 static ScrollAnalysisResult _lastScrollAnalysisResult;
 static CFTimeInterval _lastScrollAnalysisResultTimeStamp;
+
+/// Backlog coalescing
+///     When the `_scrollQueue` falls behind (e.g. after the eventTap timed out or the system was busy), several ticks pile up. Instead of restarting the animation for every one of them, we only add up their px and start a single animation for the last tick in the backlog. See `heavyProcessing()`.
+static atomic_int_fast64_t _queuedTickCount = 0; /// Incremented on the eventTap thread, decremented on the `_scrollQueue`
+static MFScrollTickCarry _tickCarry = {0}; /// Holds the backlog and the rounding error of non-animated scrolls. Only accessed on the `_scrollQueue`
 //static BOOL _isSuspended = NO; TODO: Remove suspension stuff (already commented out)
 
 #pragma mark - Public functions
@@ -109,6 +117,7 @@ void resetState_Sync(void) {
 void resetState_Unsafe(void) {
     DDLogDebug(@"reset-animator");
     [_animator cancel];
+    MFScrollTickCarryReset(&_tickCarry);
     [GestureScrollSimulator stopMomentumScroll]; /// Not sure if appropriate
     [ScrollAnalyzer resetState];
 }
@@ -214,15 +223,14 @@ static CGEventRef eventTapCallback(CGEventTapProxy proxy, CGEventType type, CGEv
 
     /// Return non-scrollwheel events unaltered
     
-    int64_t isPixelBased     = CGEventGetIntegerValueField(event, kCGScrollWheelEventIsContinuous);
-    int64_t scrollPhase      = CGEventGetIntegerValueField(event, kCGScrollWheelEventScrollPhase);
-    int64_t scrollDeltaAxis1 = CGEventGetIntegerValueField(event, kCGScrollWheelEventPointDeltaAxis1);
-    int64_t scrollDeltaAxis2 = CGEventGetIntegerValueField(event, kCGScrollWheelEventPointDeltaAxis2);
-    int64_t drawingTabletID  = CGEventGetIntegerValueField(event, kCGTabletEventDeviceID);
+    MFScrollInputRecord input;
+    MFScrollInputRecordDecode(event, &input);
+    int64_t scrollDeltaAxis1 = input.pointDeltaAxis1;
+    int64_t scrollDeltaAxis2 = input.pointDeltaAxis2;
     bool isDiagonal = scrollDeltaAxis1 != 0 && scrollDeltaAxis2 != 0;
-    if (isPixelBased != 0
-        || scrollPhase != 0 /// Not entirely sure if testing for 'scrollPhase' here makes sense
-        || drawingTabletID != 0 /// Untested
+    if (input.isContinuous != 0 /// isPixelBased
+        || input.scrollPhase != 0 /// Not entirely sure if testing for 'scrollPhase' here makes sense
+        || input.tabletDeviceID != 0 /// Untested
         || isDiagonal) {
         
         return event;
@@ -240,6 +248,7 @@ static CGEventRef eventTapCallback(CGEventTapProxy proxy, CGEventType type, CGEv
     /// Enqueue heavy processing
     ///  Executing heavy stuff on a different thread to prevent the eventTap from timing out. We wrote this before knowing that you can just re-enable the eventTap when it times out. But this doesn't hurt.
     
+    atomic_fetch_add_explicit(&_queuedTickCount, 1, memory_order_relaxed);
     dispatch_async(_scrollQueue, ^{
         heavyProcessing(eventCopy, scrollDeltaAxis1, scrollDeltaAxis2, tickTime);
     });
@@ -254,6 +263,10 @@ static void heavyProcessing(CGEventRef event, int64_t scrollDeltaAxis1, int64_t
     /// Declare stuff for later
     static DriverUnsuspender unsuspendDrivers = ^{};
     
+    /// Dequeue
+    ///     If there are more ticks waiting on the `_scrollQueue` behind this one, we're processing a backlog.
+    int64_t ticksQueuedBehindThisOne = atomic_fetch_sub_explicit(&_queuedTickCount, 1, memory_order_relaxed) - 1;
+    
     /// Debug
     if (runningPreRelease()) { /// if-statement because hidEvent.description is very slow
         
@@ -375,7 +388,10 @@ static void heavyProcessing(CGEventRef event, int64_t scrollDeltaAxis1, int64_t
         [HelperUtility displayUnderMousePointer:&displayID withEvent:event];
         
         /// Get scrollConfig
-        _scrollConfig = [ScrollConfig scrollConfigWithModifiers:newMods inputAxis:inputAxis display:displayID];
+        ///     The base is the config from the active device's profile, or `ScrollConfig.shared` if it doesn't have one. (`updateActiveDeviceWithEvent:` above has set the active device from this event.)
+        Device *device = HelperState.shared.activeDevice;
+        ScrollConfig *base = [DeviceProfiles scrollConfigForDeviceIndex:(device == nil ? kMFDeviceIndexNone : device.deviceIndex)];
+        _scrollConfig = [ScrollConfig scrollConfigWithModifiers:newMods inputAxis:inputAxis display:displayID base:base];
         
     } /// End `if (firstConsecutive) {`
     
@@ -412,8 +428,17 @@ static void heavyProcessing(CGEventRef event, int64_t scrollDeltaAxis1, int64_t
     
     /// @discussion See the RawAccel guide for more info on acceleration curves https://github.com/a1xd/rawaccel/blob/master/doc/Guide.md
     ///     -> Edit: Their whole shtick is to make the outputSpeed(inputSpeed) curve smooth. This is relatively hard and I don't think this would be noticable for scrolling. Instead we simply define a sens(inputSpeed) curve using a Bezier curve.
+    ///
+    /// @discussion pxToScrollForThisTick is a double, so fractional pixels are carried all the way into the animation target.
+    ///     We used to truncate the acceleration curve result to an integer and then multiply the truncated value with the fastScrollFactor, so the rounding error of every tick was thrown away (and amplified by fast scroll). Now we only quantize right before we send events - either in the animator's subpixelator, or in `MFScrollTickCarryApply()` when smooth scrolling is off.
     
-    int64_t pxToScrollForThisTick;
+    double pxToScrollForThisTick;
+    
+    /// Reset carried px on direction change
+    ///     Don't carry fractional px or backlogged px from the old direction over into the new one. We do this before branching on `useAppleAcceleration`: With Apple acceleration the ticks are whole px, but ticks from the old direction can still be sitting in the backlog, and there can still be a rounding error from before the config switched to Apple acceleration.
+    if (_lastScrollAnalysisResult.scrollDirectionDidChange) {
+        MFScrollTickCarryReset(&_tickCarry);
+    }
     
     if (_scrollConfig.useAppleAcceleration) {
         
@@ -446,15 +471,14 @@ static void heavyProcessing(CGEventRef event, int64_t scrollDeltaAxis1, int64_t
         /// Evaluate acceleration curve
         Curve *accelerationCurve = _scrollConfig.accelerationCurve;
         assert(accelerationCurve != nil);
-        double pxForThisTickDouble = [accelerationCurve evaluateAt:scrollSpeed]; /// In px/s
-        pxToScrollForThisTick = pxForThisTickDouble; /// We could use a SubPixelator balance out the rounding errors, but I don't think that'll be noticable
+        pxToScrollForThisTick = [accelerationCurve evaluateAt:scrollSpeed]; /// In px/s
         
         /// Debug
-        DDLogDebug(@"Acceleration curve f(%f) = %lld", scrollSpeed, pxToScrollForThisTick);
+        DDLogDebug(@"Acceleration curve f(%f) = %f", scrollSpeed, pxToScrollForThisTick);
         
         /// Validate
         if (pxToScrollForThisTick <= 0) {
-            DDLogError(@"pxForThisTick is smaller equal 0. This is invalid. Exiting. scrollSpeed: %f, pxForThisTick: %lld", scrollSpeed, pxToScrollForThisTick);
+            DDLogError(@"pxForThisTick is smaller equal 0. This is invalid. Exiting. scrollSpeed: %f, pxForThisTick: %f", scrollSpeed, pxToScrollForThisTick);
             assert(false);
         }
         
@@ -500,19 +524,43 @@ static void heavyProcessing(CGEventRef event, int64_t scrollDeltaAxis1, int64_t
         DDLogDebug(@"timeBetweenTicks: %f, timeBetweenTicksRaw: %f, diff: %f, ticks: %lld", scrollAnalysisResult.timeBetweenTicks, scrollAnalysisResult.DEBUG_timeBetweenTicksRaw, scrollAnalysisResult.timeBetweenTicks - scrollAnalysisResult.DEBUG_timeBetweenTicksRaw, scrollAnalysisResult.consecutiveScrollTickCounter);
     }
     
+    ///
+    /// Coalesce backlog and round
+    ///
+    /// Notes:
+    /// - If more ticks are already queued behind this one, we don't start an animation yet. We just remember the px and the last tick of the backlog will start a single animation towards the merged target. That way, recovering from a backlog costs one animation restart instead of one per tick.
+    /// - The scroll analysis above still runs for every tick, since it depends on the tick timestamps, which were recorded on the eventTap thread and are accurate regardless of how late we process them.
+    /// - We only do this for animated scrolling. Without the animator, there's no restart cost to avoid.
+    /// - Non-animated ticks are rounded to whole px in the same step. See ScrollTickCarry.m.
+    
+    MFScrollTickCarryResult carried = MFScrollTickCarryApply(&_tickCarry, pxToScrollForThisTick, _scrollConfig.smoothEnabled, ticksQueuedBehindThisOne);
+    
+    if (carried.isDeferred) {
+        
+        DDLogDebug(@"Scroll.m - coalescing backlogged tick. Ticks queued behind: %lld, backlogPx: %f", ticksQueuedBehindThisOne, _tickCarry.backlogPx);
+        
+        CFRelease(event);
+        return;
+    }
+    
+    pxToScrollForThisTick = carried.px;
+    
     ///
     /// Send scroll events
     ///
     
     if (pxToScrollForThisTick == 0) {
         
-        DDLogWarn(@"pxToScrollForThisTick is 0");
+        if (_scrollConfig.smoothEnabled) { /// Without smoothing, this is normal: The tick was less than half a px and is carried over to the next tick.
+            DDLogWarn(@"pxToScrollForThisTick is 0");
+        }
         
     } else if (!_scrollConfig.smoothEnabled) {
         
         /// Send scroll event directly - without the animator. Will scroll all of pxToScrollForThisTick at once.
+        ///     Already rounded to whole px by `MFScrollTickCarryApply()`
         
-        sendScroll(pxToScrollForThisTick, scrollDirection, NO, kMFAnimationCallbackPhaseNone, kMFMomentumHintNone, _scrollConfig);
+        sendScroll((int64_t)pxToScrollForThisTick, scrollDirection, NO, kMFAnimationCallbackPhaseNone, kMFMomentumHintNone, _scrollConfig);
         
     } else {
         
@@ -706,7 +754,7 @@ static void heavyProcessing(CGEventRef event, int64_t scrollDeltaAxis1, int64_t
                         .x = 1                                  / ((double)baseDuration/1000.0),
                     };
                     Vector baseCurveP1 = vectorFromDeltaAndDirectionVector(speedSmoothing, baseCurveStartDirection);
-                    baseCurve = [[Bezier alloc] initWithControlPoints:@[@[@0, @0], @[@(baseCurveP1.x), @(baseCurveP1.y)], /*@[@1, @1],*/ @[@1, @1]] defaultEpsilon:0.01];
+                    baseCurve = [[Bezier alloc] initWithControlPoints:@[@[@0, @0], @[@(baseCurveP1.x), @(baseCurveP1.y)], /*@[@1, @1],*/ @[@1, @1]] defaultEpsilon:0.01 intern:NO]; /// P1 depends on the current speed, so this shape is practically never reused
                     
                     DDLogDebug(@"Scroll.m - start speed smoothing p1 - currentSpeed: %@, bezier: %@", vectorDescription(unitVector(baseCurveP1)), [baseCurve stringTraceWithStartX:0 endX:1 nOfSamples:10 bias:1]);
                 }
@@ -742,7 +790,7 @@ static void heavyProcessing(CGEventRef event, int64_t scrollDeltaAxis1, int64_t
             p[@"curve"] = c;
             
             static double scrollDeltaSum = 0;
-            scrollDeltaSum += labs(pxToScrollForThisTick);
+            scrollDeltaSum += fabs(pxToScrollForThisTick);
 //            DDLogDebug(@"Delta sum pre-animator: %f", scrollDeltaSum);
             
             /// Return
@@ -45,6 +45,7 @@
 /// Constant
 
 static NSObject<Smoother> *_tickTimeSmoother;
+static NSDictionary *_tickTimeSmootherSpec = nil; /// The experiment spec that `_tickTimeSmoother` was created from. nil means default. See ScrollConfig > Experiment
 
 /// Dynamic
 
@@ -196,6 +197,14 @@ static CFTimeInterval _consecutiveSwipeSequenceStartTime;
         /// Note: `DBL_MAX` indicates that it has been longer than `consecutiveScrollTickIntervalMax` since the last tick. Maybe we should define a constant for this.
         smoothedTimeBetweenTicks = DBL_MAX;
         
+        /// Swap out smoother
+        ///     If the experiment config asks for a different smoother. Only doing this on the first consecutive tick, so we don't throw away smoothing state mid-swipe.
+        NSDictionary *smootherSpec = scrollConfig.tickTimeSmootherSpec;
+        if (smootherSpec != _tickTimeSmootherSpec && ![smootherSpec isEqual:_tickTimeSmootherSpec]) {
+            _tickTimeSmoother = [ScrollConfig tickTimeSmootherWithSpec:smootherSpec];
+            _tickTimeSmootherSpec = smootherSpec;
+        }
+        
         /// Reset smoother:
         [_tickTimeSmoother reset];
         
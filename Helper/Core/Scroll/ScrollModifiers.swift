@@ -29,6 +29,16 @@ extension MFScrollModificationResult: Hashable {
 
     static var activeModifications = NSDictionary()
     
+    /// Lookup cache
+    ///     See `currentModifications(event:)`
+    private struct ModificationsLookupKey: Equatable {
+        let keyboardFlags: UInt
+        let buttonSignature: UInt64
+        let kbModPriority: UInt32
+    }
+    private static var lastLookupKey: ModificationsLookupKey? = nil
+    private static var lastLookupRemaps: NSDictionary? = nil
+    
     @objc public static func currentModifications(event: CGEvent) -> MFScrollModificationResult {
         
         /// Debug
@@ -44,13 +54,36 @@ extension MFScrollModificationResult: Hashable {
         /// Get currently active scroll remaps
         
 //        let modifyingDevice: Device = HelperState.shared.activeDevice!;
-        let activeModifiers = Modifiers.modifiers(with: event)
-//        let baseRemaps = Remap.remaps;
         
-        /// Debug
-//        DDLogDebug("activeFlags in ScrollModifers: \(SharedUtility.binaryRepresentation((activeModifiers[kMFModificationPreconditionKeyKeyboard] as? NSNumber)?.uint32Value ?? 0))") /// This is unbelievably slow for some reason
+        /// Notes on the fast path:
+        /// - This runs for every scroll event. Getting the modifications means updating and hashing the modifiers dict and looking it up in Remap's cache. If neither the modifiers nor the remaps changed since the last event, we just reuse the last modifications.
+        /// - The button modifiers are read lock-free from ButtonModifiers (See `MFButtonModifiersRead()`). ButtonModifiers publishes after updating `Modifiers`, so if we see the new signature, `Modifiers` also has the new state.
+        /// - When kbMods are actively listened to, the kbMods in `Modifiers` are updated by the kbMod eventTap, which might lag behind the flags on this event. So we can't use the event flags as a key and always take the slow path.
+        /// - Signatures of more than 4 button modifiers aren't exact, so we take the slow path for those, too.
+        
+        let buttonModifiers = MFButtonModifiersRead()
+        let kbModPriority = Modifiers.kbModPriority()
+        let lookupKey = ModificationsLookupKey(keyboardFlags: Modifiers.keyboardModifierFlags(with: event), buttonSignature: buttonModifiers.signature, kbModPriority: kbModPriority.rawValue)
+        let remaps = Remap.remaps
+        
+        let canReuse = kbModPriority != kMFModifierPriorityActiveListen
+                        && buttonModifiers.signature != kMFButtonModifierSignatureInexact
+                        && lookupKey == lastLookupKey
+                        && remaps === lastLookupRemaps
         
-        self.activeModifications = Remap.modifications(withModifiers: activeModifiers) ?? NSDictionary()
+        if !canReuse {
+            
+            let activeModifiers = Modifiers.modifiers(with: event)
+//            let baseRemaps = Remap.remaps;
+            
+            /// Debug
+//            DDLogDebug("activeFlags in ScrollModifers: \(SharedUtility.binaryRepresentation((activeModifiers[kMFModificationPreconditionKeyKeyboard] as? NSNumber)?.uint32Value ?? 0))") /// This is unbelievably slow for some reason
+            
+            self.activeModifications = Remap.modifications(withModifiers: activeModifiers) ?? NSDictionary()
+            
+            lastLookupKey = lookupKey
+            lastLookupRemaps = remaps
+        }
         
         guard let modifiedScrollDict = activeModifications[kMFTriggerScroll] else {
             return result; /// There are no active scroll modifications
@@ -0,0 +1,33 @@
+//
+// --------------------------------------------------------------------------
+// ScrollTickCarry.h
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// The step in Scroll.m between "the acceleration curve says this tick is worth x px" and "send x px". See ScrollTickCarry.m for discussion.
+
+#import <stdbool.h>
+#import <stdint.h>
+
+#pragma mark - Types
+
+typedef struct {
+    double backlogPx;       /// px of ticks that were coalesced into a later tick and haven't been scrolled yet
+    double roundingErrorPx; /// Fractional px that direct (non-animated) scrolling hasn't sent yet
+} MFScrollTickCarry;
+
+typedef struct {
+    bool isDeferred;        /// The tick went into the backlog. Don't scroll anything for it.
+    double px;              /// The px to scroll for this tick, including the backlog. Whole px if the tick isn't animated.
+} MFScrollTickCarryResult;
+
+#pragma mark - Functions
+
+/// Drops the backlog and the rounding error. Call this on direction change, so px from the old direction don't leak into the new one.
+void MFScrollTickCarryReset(MFScrollTickCarry *carry);
+
+/// Takes the fractional `px` for one tick and returns what should be scrolled for it.
+MFScrollTickCarryResult MFScrollTickCarryApply(MFScrollTickCarry *carry, double px, bool isAnimated, int64_t ticksQueuedBehind);
@@ -0,0 +1,51 @@
+//
+// --------------------------------------------------------------------------
+// ScrollTickCarry.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Why:
+///     The acceleration curve and fastScroll give a fractional px distance for every tick. We used to truncate that per tick, so the rounding error of every tick was thrown away. This carries it instead.
+///     It's split out of Scroll.m's `heavyProcessing()` so ScrollTickCarryTests can replay long tick sequences through the same code that Scroll.m runs.
+///
+/// How:
+///     - Animated ticks that have more ticks queued behind them go into the backlog. The last tick of the backlog gets all of the backlog's px, so the animation is only restarted once. (See "Coalesce backlog" in Scroll.m)
+///     - Animated ticks aren't rounded here. The animator quantizes through its own subpixelator.
+///     - Non-animated ticks are rounded to whole px, and the rounding error is added to the next tick. So the total distance sent is never more than 0.5 px off from the total that the curve asked for.
+///
+/// Notes:
+///     - Plain C without state of its own. Scroll.m keeps the `MFScrollTickCarry` and only touches it on the `_scrollQueue`.
+
+#import "ScrollTickCarry.h"
+#import <math.h>
+
+void MFScrollTickCarryReset(MFScrollTickCarry *carry) {
+    carry->backlogPx = 0.0;
+    carry->roundingErrorPx = 0.0;
+}
+
+MFScrollTickCarryResult MFScrollTickCarryApply(MFScrollTickCarry *carry, double px, bool isAnimated, int64_t ticksQueuedBehind) {
+    
+    /// Coalesce backlog
+    ///     Only for animated scrolling. Without the animator, there's no restart cost to avoid.
+    if (isAnimated && ticksQueuedBehind > 0) {
+        carry->backlogPx += px;
+        return (MFScrollTickCarryResult){ .isDeferred = true, .px = 0.0 };
+    }
+    
+    /// Take backlog
+    px += carry->backlogPx;
+    carry->backlogPx = 0.0;
+    
+    /// Round
+    if (!isAnimated) {
+        double precisePx = px + carry->roundingErrorPx;
+        px = round(precisePx);
+        carry->roundingErrorPx = precisePx - px;
+    }
+    
+    return (MFScrollTickCarryResult){ .isDeferred = false, .px = px };
+}
@@ -15,6 +15,7 @@
 #import "SharedUtility.h"
 #import "VectorSubPixelator.h"
 #import "ModificationUtility.h"
+#import "EventFieldCodec.h"
 #import "Mac_Mouse_Fix_Helper-Swift.h"
 #import "WannabePrefixHeader.h"
 
@@ -539,33 +540,36 @@ static void getDeltaVectors(Vector point, VectorSubPixelator *subPixelator, Vect
     
     CGEventRef e22 = CGEventCreate(NULL);
     
-    /// Set static fields
-    
-    CGEventSetIntegerValueField(e22, 55, 22); /// 22 -> NSEventTypeScrollWheel // Setting field 55 is the same as using CGEventSetType(), I'm not sure if that has weird side-effects though, so I'd rather do it this way.
-    CGEventSetIntegerValueField(e22, 88, 1); /// 88 -> kCGScrollWheelEventIsContinuous
-    CGEventSetIntegerValueField(e22, 137, invertedFromDevice ? 1 : 0); /// I think this is NSEvent.directionInvertedFromDevice. Will flip direction of unread swiping in Mail
-    
-    /// Set dynamic fields
-    
-    /// Scroll deltas
-    /// Notes:
+    /// Fill record
+    ///     The field numbers live in the table in EventFieldCodec.h
+    ///
+    /// Notes on scroll deltas:
     ///     - Fixed point deltas are set automatically by setting these deltas IIRC.
     ///         - Edit: Under Ventura Beta, the fixed point deltas are not automatically being set. Not sure if this was ever the case. So we're setting it manually now. Edit 2: Under a later Ventura Beta they ARE set automatically. The fixedPt delta (kCGScrollWheelEventFixedPtDeltaAxis1) is automatically set to the same value as the "normal" delta (kCGScrollWheelEventDeltaAxis1). But if we look at real trackpad values it's more complicated. So we're setting our own values to be more true to how the trackpad works
     ///
     ///     - Doing similar things in see Scroll.m line-scroll-generation
     
-    CGEventSetIntegerValueField(e22, 11, vecScrollLineInt.y); /// 11 -> kCGScrollWheelEventDeltaAxis1
-    CGEventSetIntegerValueField(e22, 96, vecScrollPoint.y); /// 96 -> kCGScrollWheelEventPointDeltaAxis1
-    CGEventSetIntegerValueField(e22, 93, fixedScrollDelta(vecScrollLine.y)); /// 93 -> kCGScrollWheelEventFixedPtDeltaAxis1
-    
-    CGEventSetIntegerValueField(e22, 12, vecScrollLineInt.x); /// 12 -> kCGScrollWheelEventDeltaAxis2
-    CGEventSetIntegerValueField(e22, 97, vecScrollPoint.x); /// 97 -> kCGScrollWheelEventPointDeltaAxis2
-    CGEventSetIntegerValueField(e22, 94, fixedScrollDelta(vecScrollLine.x)); /// 94 -> kCGScrollWheelEventFixedPtDeltaAxis2
-    
-    /// Phase
-    
-    CGEventSetIntegerValueField(e22, 99, phase);
-    CGEventSetIntegerValueField(e22, 123, momentumPhase);
+    MFScrollEventRecord r22 = {
+        
+        /// Static fields
+        .type = 22, /// 22 -> NSEventTypeScrollWheel // Setting field 55 is the same as using CGEventSetType(), I'm not sure if that has weird side-effects though, so I'd rather do it this way.
+        .isContinuous = 1,
+        .invertedFromDevice = invertedFromDevice ? 1 : 0, /// I think this is NSEvent.directionInvertedFromDevice. Will flip direction of unread swiping in Mail
+        
+        /// Scroll deltas
+        .deltaAxis1 = vecScrollLineInt.y,
+        .pointDeltaAxis1 = vecScrollPoint.y,
+        .fixedPtDeltaAxis1 = fixedScrollDelta(vecScrollLine.y),
+        
+        .deltaAxis2 = vecScrollLineInt.x,
+        .pointDeltaAxis2 = vecScrollPoint.x,
+        .fixedPtDeltaAxis2 = fixedScrollDelta(vecScrollLine.x),
+        
+        /// Phase
+        .scrollPhase = phase,
+        .momentumPhase = momentumPhase,
+    };
+    MFScrollEventRecordEncode(&r22, e22);
 
     /// Debug
     
@@ -587,23 +591,21 @@ static void getDeltaVectors(Vector point, VectorSubPixelator *subPixelator, Vect
         
         CGEventRef e29 = CGEventCreate(NULL);
         
-        /// Set static fields
-        
-        CGEventSetIntegerValueField(e29, 55, 29); /// 29 -> NSEventTypeGesture // Setting field 55 is the same as using CGEventSetType()
-        CGEventSetIntegerValueField(e29, 110, 6); /// 110 -> subtype // 6 -> kIOHIDEventTypeScroll
-        
-        /// Set dynamic fields
-        
-        /// Deltas
+        /// Get deltas
         double dxGesture = (double)vecGesture.x;
         double dyGesture = (double)vecGesture.y;
         if (dxGesture == 0) dxGesture = -0.0f; /// The original events only contain -0 but this probably doesn't make a difference.
         if (dyGesture == 0) dyGesture = -0.0f;
-        CGEventSetDoubleValueField(e29, 116, dxGesture);
-        CGEventSetDoubleValueField(e29, 119, dyGesture);
         
-        /// Phase
-        CGEventSetIntegerValueField(e29, 132, phase);
+        /// Fill record
+        MFGestureScrollEventRecord r29 = {
+            .type = 29,     /// 29 -> NSEventTypeGesture // Setting field 55 is the same as using CGEventSetType()
+            .subtype = 6,   /// 6 -> kIOHIDEventTypeScroll
+            .deltaX = dxGesture,
+            .deltaY = dyGesture,
+            .phase = phase,
+        };
+        MFGestureScrollEventRecordEncode(&r29, e29);
         
         /// Post t29s6 events
         CGEventSetTimestamp(e29, eventTs);
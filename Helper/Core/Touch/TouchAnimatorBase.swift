@@ -64,6 +64,7 @@ import QuartzCore
     /// Constants
     
     let maxAnimationDuration = 1.5 /*5.0*/ /// Explanation below. TODO: Move this into ScrollConfig.
+    static let minBaseCurveTime = ScrollConfig().consecutiveScrollTickIntervalMax /// Explanation in displayLinkCallback. We used to create a new ScrollConfig for this on every frame.
     
     /// Vars - Init
     
@@ -72,7 +73,14 @@ import QuartzCore
     /// ^ This is constantly accessed by subclassHook() and constantly written to by startWithUntypedCallback(). Becuase Swift is stinky and not thread safe, the app will sometimes crash, when this property is read from and written to at the same time. So we're using @Atomic propery wrapper
     ///  Edit: Atomic makes writing to this super slow we're locking everything with displayLink.queue now so it shouldn't be necessary. Disabling @Atomc now.
     
-    @objc var animationCurve: Curve? /// This class assumes that `animationCurve` passes through `(0, 0)` and `(1, 1)
+    @objc var animationCurve: Curve? { /// This class assumes that `animationCurve` passes through `(0, 0)` and `(1, 1)
+        didSet {
+            /// Cache momentumHint threshold
+            ///     So the displayLinkCallback can get the momentumHint with 2 comparisons instead of 2 `subCurve(at:)` calls every frame. nil means that the curve isn't a HybridCurve and there's no momentumHint.
+            momentumThresholdTimeUnit = (animationCurve as? HybridCurve)?.dragStartTimeUnit
+        }
+    }
+    private var momentumThresholdTimeUnit: Double? = nil
     
 //    let threadLock = DispatchSemaphore.init(value: 1)
     /// ^ Using a queue instead of a lock to avoid deadlocks. Always use queues for mutual exclusion except if you know exactly what you're doing!
@@ -553,24 +561,18 @@ import QuartzCore
         
         var momentumHint: MFMomentumHint = kMFMomentumHintNone
         
-        if let hybridCurve = animationCurve as? HybridCurve {
+        if let threshold = momentumThresholdTimeUnit {
             
             /// Get subcurve
-            var subCurve = hybridCurve.subCurve(at: animationTimeUnit)
-            /// Set subCurve to base
-            ///     We only want to set the curve to drag if all of the pixels to be scrolled for the frame come from the DragCurve
-            if lastAnimationTimeUnit != -1 {
-                let lastSubCurve = hybridCurve.subCurve(at: lastAnimationTimeUnit)
-                /// ^ Can't use `lastSubCurve` instance prop because it would never change
-                if lastSubCurve == kMFHybridSubCurveBase {
-                    subCurve = kMFHybridSubCurveBase
-                }
-            }
+            ///     This is equivalent to `HybridCurve.subCurve(at:)` but compares against the threshold we cached when the curve was set.
+            ///     We only want to set the curve to drag if all of the pixels to be scrolled for the frame come from the DragCurve. So if the last frame was still on the baseCurve, we stay on the baseCurve.
+            let lastWasBase = lastAnimationTimeUnit != -1 && lastAnimationTimeUnit <= threshold
+            let isBase = animationTimeUnit <= threshold || lastWasBase
             
             /// Do get momentumHint
             
             let timeSinceAnimationStart = frameTime - animationStartTime
-            let minBaseCurveTime = ScrollConfig().consecutiveScrollTickIntervalMax
+            let minBaseCurveTime = TouchAnimatorBase.minBaseCurveTime
             
             /// DEBUG
 //            minBaseCurveTime = 0.0
@@ -589,13 +591,12 @@ import QuartzCore
                 momentumHint = kMFMomentumHintGesture
                 
             } else {
-                if subCurve == kMFHybridSubCurveBase {
-                    momentumHint = kMFMomentumHintGesture
-                } else if subCurve == kMFHybridSubCurveDrag {
-                    momentumHint = kMFMomentumHintMomentum
-                } else {
-                    assert(false)
-                }
+                momentumHint = isBase ? kMFMomentumHintGesture : kMFMomentumHintMomentum
+            }
+            
+            /// Debug
+            if momentumHint != lastMomentumHint && lastMomentumHint != kMFMomentumHintNone {
+                DDLogDebug("TouchAnimator - momentumHint transition \(lastMomentumHint) -> \(momentumHint) at animationTimeUnit \(animationTimeUnit), threshold: \(threshold)")
             }
         }
         
@@ -60,8 +60,12 @@ import CoreGraphics
     private var _activeDevice: Device? = nil
     @objc var activeDevice: Device? {
         set {
+            let didChange = newValue !== _activeDevice
             _activeDevice = newValue
             SwitchMaster.shared.helperStateChanged()
+            if didChange { /// This is set on every input event. Only publish actual changes, since that looks up the device name and writes the shared status block.
+                publishActiveDevice(newValue)
+            }
         }
         get {
             if _activeDevice != nil {
@@ -73,6 +77,23 @@ import CoreGraphics
         }
     }
     
+    private func publishActiveDevice(_ device: Device?) {
+        
+        /// Write the device into the MFSharedStatus block, so the mainApp can display it without a message round trip.
+        ///     The name is truncated to fit the fixed-size buffer and is always 0-terminated.
+        
+        let name = Array((device?.name() ?? "").utf8.prefix(Int(kMFSharedStatusDeviceNameCapacity) - 1))
+        let nOfButtons = UInt32(clamping: device?.nOfButtons() ?? 0)
+        
+        MFSharedStatusUpdate { status in
+            status.pointee.activeDeviceButtonCount = nOfButtons
+            withUnsafeMutableBytes(of: &status.pointee.activeDeviceName) { buffer in
+                buffer.initializeMemory(as: UInt8.self, repeating: 0)
+                buffer.copyBytes(from: name)
+            }
+        }
+    }
+    
     @objc func updateActiveDevice(event: CGEvent) {
         guard let iohidDevice = CGEventGetSendingDevice(event)?.takeUnretainedValue() else { return }
         updateActiveDevice(IOHIDDevice: iohidDevice)
@@ -14,6 +14,7 @@
 #import "SubPixelator.h"
 #import "VectorSubPixelator.h"
 #import "SharedUtility.h"
+#import "MFAtomic.h"
 #import "HelperUtility.h"
 #import "CircularBuffer.h"
 #import "ScrollModifiers.h"
@@ -45,5 +46,6 @@
 #import "NSScreen+Additions.h"
 #import "Device.h"
 #import "ButtonModifiers.h"
+#import "MFSharedStatus.h"
 
 //#import <CocoaLumberjack/CocoaLumberjack.h> /// Importing CocoaLumberjack/Swift with CocoaPods breaks my project. Can't use macros when importing this.
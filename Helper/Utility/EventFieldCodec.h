@@ -0,0 +1,72 @@
+//
+// --------------------------------------------------------------------------
+// EventFieldCodec.h
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Reads and writes whole scroll / gesture event records through a field table. See EventFieldCodec.m for discussion.
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#pragma mark - Field tables
+
+/// Each entry is `X(member, field, kind)`
+///     - `field` is the CGEventField. Where there's no public constant, we use the raw number. (Found those by looking at real trackpad events, see GestureScrollSimulator.m)
+///     - `kind` is `Int` or `Double` and decides which CGEvent getter/setter is used, and the type of the member.
+
+/// What the scroll eventTap needs to decide whether to handle an event
+#define MF_SCROLL_INPUT_FIELDS(X) \
+    X(isContinuous,         kCGScrollWheelEventIsContinuous,        Int) \
+    X(scrollPhase,          kCGScrollWheelEventScrollPhase,         Int) \
+    X(pointDeltaAxis1,      kCGScrollWheelEventPointDeltaAxis1,     Int) \
+    X(pointDeltaAxis2,      kCGScrollWheelEventPointDeltaAxis2,     Int) \
+    X(tabletDeviceID,       kCGTabletEventDeviceID,                 Int)
+
+/// Type 22 event (scroll wheel) as we send it
+#define MF_SCROLL_EVENT_FIELDS(X) \
+    X(type,                 55,                                     Int) \
+    X(isContinuous,         kCGScrollWheelEventIsContinuous,        Int) \
+    X(invertedFromDevice,   137,                                    Int) \
+    X(deltaAxis1,           kCGScrollWheelEventDeltaAxis1,          Int) \
+    X(pointDeltaAxis1,      kCGScrollWheelEventPointDeltaAxis1,     Int) \
+    X(fixedPtDeltaAxis1,    kCGScrollWheelEventFixedPtDeltaAxis1,   Int) \
+    X(deltaAxis2,           kCGScrollWheelEventDeltaAxis2,          Int) \
+    X(pointDeltaAxis2,      kCGScrollWheelEventPointDeltaAxis2,     Int) \
+    X(fixedPtDeltaAxis2,    kCGScrollWheelEventFixedPtDeltaAxis2,   Int) \
+    X(scrollPhase,          kCGScrollWheelEventScrollPhase,         Int) \
+    X(momentumPhase,        kCGScrollWheelEventMomentumPhase,       Int)
+
+/// Type 29 subtype 6 event (gesture scroll) as we send it
+#define MF_GESTURE_SCROLL_EVENT_FIELDS(X) \
+    X(type,                 55,                                     Int) \
+    X(subtype,              110,                                    Int) \
+    X(deltaX,               116,                                    Double) \
+    X(deltaY,               119,                                    Double) \
+    X(phase,                132,                                    Int)
+
+#pragma mark - Records
+
+#define MF_EVENT_FIELD_TYPE_Int int64_t
+#define MF_EVENT_FIELD_TYPE_Double double
+#define MF_EVENT_FIELD_MEMBER(member, field, kind) MF_EVENT_FIELD_TYPE_##kind member;
+
+typedef struct { MF_SCROLL_INPUT_FIELDS(MF_EVENT_FIELD_MEMBER) } MFScrollInputRecord;
+typedef struct { MF_SCROLL_EVENT_FIELDS(MF_EVENT_FIELD_MEMBER) } MFScrollEventRecord;
+typedef struct { MF_GESTURE_SCROLL_EVENT_FIELDS(MF_EVENT_FIELD_MEMBER) } MFGestureScrollEventRecord;
+
+#pragma mark - Codec
+
+/// Scroll.m's eventTap reads the input fields, GestureScrollSimulator.m writes the events it sends.
+
+void MFScrollInputRecordDecode(CGEventRef event, MFScrollInputRecord *outRecord);
+
+void MFScrollEventRecordEncode(const MFScrollEventRecord *record, CGEventRef event);
+void MFGestureScrollEventRecordEncode(const MFGestureScrollEventRecord *record, CGEventRef event);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,93 @@
+//
+// --------------------------------------------------------------------------
+// EventFieldCodec.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Why:
+///     Scroll.m and GestureScrollSimulator.m each read and write scroll and gesture events one field at a time, with the field numbers and their meanings repeated (and commented) at every call site. Some of the numbers are undocumented and only known from looking at real trackpad events, so it's easy to get one wrong in one place.
+///
+/// How:
+///     - The fields for each kind of record are listed once in a table in the header (an 'X-macro'). The compiler expands that table into the record struct and a static array of `{field, kind, offset}` descriptors. So the table is the single place that knows the layout. Adding a field is one line.
+///     - Decoding and encoding are a single loop over the descriptor array that calls the matching CGEvent getter/setter and reads/writes the member at its offset. No allocations, no ObjC messages.
+///     - We only have the directions that are actually used: Decoding for the scroll input, encoding for the events we send. The tables work both ways, so adding the other direction is a one-liner.
+///
+/// Notes:
+///     - We originally wanted to decode the whole event from the underlying `IOHIDEvent` bytes in one go (see CGEventHIDEventBridge and `IOHIDEventFieldDefs.h`). But the byte layout of CGEvent and HIDEvent is private and changes between macOS versions, and `CGEventCopyIOHIDEvent()` doesn't even work for all event types. The CGEvent field API is the stable interface, so the codec goes through that.
+
+#import "EventFieldCodec.h"
+#import <stddef.h>
+
+#pragma mark - Descriptors
+
+typedef enum : uint8_t {
+    kMFEventFieldKindInt,
+    kMFEventFieldKindDouble,
+} MFEventFieldKind;
+
+typedef struct {
+    CGEventField field;
+    MFEventFieldKind kind;
+    uint16_t offset;
+} MFEventFieldDescriptor;
+
+#define MF_EVENT_FIELD_DESCRIPTOR(recordType, member, field_, kind_) \
+    { .field = (CGEventField)(field_), .kind = kMFEventFieldKind##kind_, .offset = offsetof(recordType, member) },
+
+#define MF_SCROLL_INPUT_DESCRIPTOR(member, field, kind)         MF_EVENT_FIELD_DESCRIPTOR(MFScrollInputRecord, member, field, kind)
+#define MF_SCROLL_EVENT_DESCRIPTOR(member, field, kind)         MF_EVENT_FIELD_DESCRIPTOR(MFScrollEventRecord, member, field, kind)
+#define MF_GESTURE_SCROLL_EVENT_DESCRIPTOR(member, field, kind) MF_EVENT_FIELD_DESCRIPTOR(MFGestureScrollEventRecord, member, field, kind)
+
+static const MFEventFieldDescriptor _scrollInputFields[]        = { MF_SCROLL_INPUT_FIELDS(MF_SCROLL_INPUT_DESCRIPTOR) };
+static const MFEventFieldDescriptor _scrollEventFields[]        = { MF_SCROLL_EVENT_FIELDS(MF_SCROLL_EVENT_DESCRIPTOR) };
+static const MFEventFieldDescriptor _gestureScrollEventFields[] = { MF_GESTURE_SCROLL_EVENT_FIELDS(MF_GESTURE_SCROLL_EVENT_DESCRIPTOR) };
+
+#define MF_COUNT(array) (sizeof(array) / sizeof((array)[0]))
+
+/// Validate layout
+///     Every member is 8 bytes -> No padding, record size is a multiple of 8
+_Static_assert(sizeof(MFScrollInputRecord)          == 8 * MF_COUNT(_scrollInputFields), "");
+_Static_assert(sizeof(MFScrollEventRecord)          == 8 * MF_COUNT(_scrollEventFields), "");
+_Static_assert(sizeof(MFGestureScrollEventRecord)   == 8 * MF_COUNT(_gestureScrollEventFields), "");
+
+#pragma mark - Codec
+
+static inline void decode(CGEventRef event, const MFEventFieldDescriptor *table, size_t count, void *record) {
+
+    uint8_t *base = record;
+    for (size_t i = 0; i < count; i++) {
+        const MFEventFieldDescriptor *d = &table[i];
+        if (d->kind == kMFEventFieldKindInt) {
+            *(int64_t *)(base + d->offset) = CGEventGetIntegerValueField(event, d->field);
+        } else {
+            *(double *)(base + d->offset) = CGEventGetDoubleValueField(event, d->field);
+        }
+    }
+}
+
+static inline void encode(const void *record, const MFEventFieldDescriptor *table, size_t count, CGEventRef event) {
+
+    const uint8_t *base = record;
+    for (size_t i = 0; i < count; i++) {
+        const MFEventFieldDescriptor *d = &table[i];
+        if (d->kind == kMFEventFieldKindInt) {
+            CGEventSetIntegerValueField(event, d->field, *(const int64_t *)(base + d->offset));
+        } else {
+            CGEventSetDoubleValueField(event, d->field, *(const double *)(base + d->offset));
+        }
+    }
+}
+
+void MFScrollInputRecordDecode(CGEventRef event, MFScrollInputRecord *outRecord) {
+    decode(event, _scrollInputFields, MF_COUNT(_scrollInputFields), outRecord);
+}
+
+void MFScrollEventRecordEncode(const MFScrollEventRecord *record, CGEventRef event) {
+    encode(record, _scrollEventFields, MF_COUNT(_scrollEventFields), event);
+}
+void MFGestureScrollEventRecordEncode(const MFGestureScrollEventRecord *record, CGEventRef event) {
+    encode(record, _gestureScrollEventFields, MF_COUNT(_gestureScrollEventFields), event);
+}
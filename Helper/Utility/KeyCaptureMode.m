@@ -12,6 +12,7 @@
 #import "WannabePrefixHeader.h"
 #import "ModificationUtility.h"
 #import "MFMessagePort.h"
+#import "MFSharedStatus.h"
 
 @implementation KeyCaptureMode
 
@@ -30,10 +31,12 @@ CFMachPortRef _keyCaptureEventTap;
         _keyCaptureEventTap = [ModificationUtility createEventTapWithLocation:kCGHIDEventTap mask:CGEventMaskBit(kCGEventKeyDown) | CGEventMaskBit(NSEventTypeSystemDefined) option:kCGEventTapOptionDefault placement:kCGHeadInsertEventTap callback:keyCaptureModeCallback];
     }
     CGEventTapEnable(_keyCaptureEventTap, true);
+    MFSharedStatusUpdate(^(MFSharedStatus *status) { status->keyCaptureModeIsEnabled = true; });
 }
 
 + (void)disable {
     CGEventTapEnable(_keyCaptureEventTap, false);
+    MFSharedStatusUpdate(^(MFSharedStatus *status) { status->keyCaptureModeIsEnabled = false; });
 }
 
 CGEventRef  _Nullable keyCaptureModeCallback(CGEventTapProxy proxy, CGEventType type, CGEventRef event, void *userInfo) {
@@ -53,7 +56,9 @@ CGEventRef  _Nullable keyCaptureModeCallback(CGEventTapProxy proxy, CGEventType
                 @"flags": @(flags),
             };
             
-            [MFMessagePort sendMessage:@"keyCaptureModeFeedback" withPayload:payload waitForReply:NO];
+            if (!MFSharedStatusPushFeedback(@"keyCaptureModeFeedback", payload)) {
+                [MFMessagePort sendMessage:@"keyCaptureModeFeedback" withPayload:payload waitForReply:NO];
+            }
             [KeyCaptureMode disable];
         }
         
@@ -72,7 +77,9 @@ CGEventRef  _Nullable keyCaptureModeCallback(CGEventTapProxy proxy, CGEventType
                 @"flags": @(flags),
             };
             
-            [MFMessagePort sendMessage:@"keyCaptureModeFeedbackWithSystemEvent" withPayload:payload waitForReply:NO];
+            if (!MFSharedStatusPushFeedback(@"keyCaptureModeFeedbackWithSystemEvent", payload)) {
+                [MFMessagePort sendMessage:@"keyCaptureModeFeedbackWithSystemEvent" withPayload:payload waitForReply:NO];
+            }
             [KeyCaptureMode disable];
         }
         
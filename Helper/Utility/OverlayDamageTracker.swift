@@ -0,0 +1,111 @@
+//
+// --------------------------------------------------------------------------
+// OverlayDamageTracker.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Bookkeeping for the sprites that `ScreenDrawer` displays. Collects changes between display frames and hands them out as one update per frame.
+///
+/// __Why__
+/// - The puppet cursor in `PointerFreeze` is moved on every mouseMoved event. Mice can send those at 1000 Hz, but the screen only refreshes at 60 - 120 Hz. Before, every single event did a `dispatch_sync` to the main thread and repositioned an NSView, so most of that work was thrown away before it ever reached the screen.
+///
+/// __How__
+/// - Writers (any thread, under `ScreenDrawer`'s lock) record the latest frame and visibility for each slot. Multiple changes to the same slot before the next frame just overwrite each other.
+/// - Once per display frame, `ScreenDrawer` calls `takeUpdate()`. That returns the slots that changed since the last call (the 'damage'). If nothing changed, it returns 0 and `ScreenDrawer` doesn't touch the layer tree at all.
+/// - After `idleFramesBeforeStop` frames without any changes, `takeUpdate()` tells the caller it can stop its display link.
+///
+/// __Notes__
+/// - This only depends on Foundation and doesn't know about layers or windows, so it's easy to test and profile in isolation.
+/// - The number of slots is fixed, so there's no allocation after init. Slot indexes are handed out by the caller.
+/// - We only track which slots changed, not which screen area changed. The sprites are CALayers, and Core Animation already works out itself which parts of the screen it needs to recomposite.
+
+import Foundation
+
+struct OverlayDamageTracker {
+
+    /// Types
+
+    struct Slot {
+        var frame: CGRect = .zero
+        var isVisible: Bool = false
+    }
+
+    /// Constants
+
+    static let maxCapacity = 32 /// Limited by the bitmask that `takeUpdate()` returns
+    let idleFramesBeforeStop: Int
+
+    /// Storage
+
+    private(set) var slots: [Slot]                  /// Latest requested state
+    private var displayedSlots: [Slot]              /// State as of the last `takeUpdate()`
+    private var dirtySlots: UInt32 = 0
+    private var idleFrames: Int = 0
+
+    /// Init
+
+    init(capacity: Int, idleFramesBeforeStop: Int = 30) {
+        assert(capacity > 0 && capacity <= OverlayDamageTracker.maxCapacity)
+        self.slots = [Slot](repeating: Slot(), count: capacity)
+        self.displayedSlots = self.slots
+        self.idleFramesBeforeStop = idleFramesBeforeStop
+    }
+
+    /// Writing
+
+    mutating func setFrame(_ frame: CGRect, forSlot i: Int) {
+        guard slots[i].frame != frame else { return }
+        slots[i].frame = frame
+        dirtySlots |= 1 << UInt32(i)
+    }
+
+    mutating func setOrigin(_ origin: CGPoint, forSlot i: Int) {
+        setFrame(CGRect(origin: origin, size: slots[i].frame.size), forSlot: i)
+    }
+
+    mutating func setVisible(_ isVisible: Bool, forSlot i: Int) {
+        guard slots[i].isVisible != isVisible else { return }
+        slots[i].isVisible = isVisible
+        dirtySlots |= 1 << UInt32(i)
+    }
+
+    var hasVisibleSlots: Bool {
+        return slots.contains { $0.isVisible }
+    }
+
+    /// Reading
+
+    mutating func takeUpdate() -> (changedSlots: UInt32, shouldStop: Bool) {
+
+        /// Called once per display frame
+        ///     `changedSlots` is a bitmask. Bit i is set if slot i changed.
+
+        /// Nothing changed
+        if dirtySlots == 0 {
+            idleFrames += 1
+            return (0, idleFrames >= idleFramesBeforeStop)
+        }
+        idleFrames = 0
+
+        /// Collect changed slots
+        ///     Changes that cancel each other out (e.g. moved away and back before the frame) are dropped here.
+        var changed: UInt32 = 0
+        var remaining = dirtySlots
+        while remaining != 0 {
+            let i = remaining.trailingZeroBitCount
+            remaining &= remaining - 1
+
+            let old = displayedSlots[i], new = slots[i]
+            guard old.frame != new.frame || old.isVisible != new.isVisible else { continue }
+
+            changed |= 1 << UInt32(i)
+            displayedSlots[i] = new
+        }
+        dirtySlots = 0
+
+        return (changed, false)
+    }
+}
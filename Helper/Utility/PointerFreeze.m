@@ -28,7 +28,7 @@ static BOOL _keepPointerMoving;
 
 static int _cgsConnection; /// This is used by private APIs to talk to the window server and do fancy shit like hiding the cursor from a background application
 static NSCursor *_puppetCursor;
-static NSImageView *_puppetCursorView;
+static NSInteger _puppetCursorSprite = -1; /// Index of the ScreenDrawer sprite. -1 if not drawn
 static CGDirectDisplayID _display;
 
 static CFMachPortRef _eventTap;
@@ -60,15 +60,6 @@ static int64_t _lastEventDelta;
         dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INTERACTIVE, -1);
         _queue = dispatch_queue_create("com.nuebling.mac-mouse-fix.helper.pointer", attr);
         
-        if (NSThread.isMainThread) {
-            _puppetCursorView = [[NSImageView alloc] init];
-        } else {
-            dispatch_sync(dispatch_get_main_queue(), ^{
-                /// Setup puppet cursor
-                _puppetCursorView = [[NSImageView alloc] init];
-            });
-        }
-        
         /// Setup eventTap
         ///     Using a listenOnly tap would be more appropriate but they sometimes behave weirdly
         _eventTap = [ModificationUtility createEventTapWithLocation:kCGHIDEventTap mask:CGEventMaskBit(kCGEventMouseMoved) | CGEventMaskBit(kCGEventLeftMouseDragged) | CGEventMaskBit(kCGEventRightMouseDragged) | CGEventMaskBit(kCGEventOtherMouseDragged) option:kCGEventTapOptionDefault placement:kCGHeadInsertEventTap callback:mouseMovedCallback runLoop:GlobalEventTapThread.runLoop];
@@ -374,38 +365,31 @@ void setSuppressionIntervalWithTimeInterval(CFTimeInterval interval) {
     NSRect puppetImageFrame = NSMakeRect(imageLoc.x, imageLoc.y, _puppetCursor.image.size.width, _puppetCursor.image.size.height);
     NSRect puppetImageFrameUnflipped = [SharedUtility quartzToCocoaScreenSpace:puppetImageFrame];
     
+    /// Reposition puppet cursor
+    ///     This is the hot path - it's called for every mouse moved event. ScreenDrawer's sprites can be moved from any thread and the moves are coalesced to one per display frame, so we don't need to go through the main thread here.
+    if (draw && !fresh) {
+        [ScreenDrawer.shared moveSprite:_puppetCursorSprite toOrigin:puppetImageFrameUnflipped.origin];
+        return;
+    }
+    
     /// Define mainthread workload
     
     void (^workload)(void) = ^{
         
         /// Normal undraw
         ///     We need to use normal undraw instead of "efficient undraw" (see above) because (at least under Ventura Beta) mouseMoved causes CPU usage as long as the ScreenDrawers `canvas` window is open.
-        ///     We might be able to somehow fix this when setting up the canvas in `ScreenDrawer.load_Manual()`
+        ///     ScreenDrawer closes the canvas once no sprites are left.
         if (!draw) {
-            [ScreenDrawer.shared undrawWithView:_puppetCursorView];
+            [ScreenDrawer.shared undrawSprite:_puppetCursorSprite];
+            _puppetCursorSprite = -1;
             return;
         }
         
-        /// Store image of cursor into puppetView
-        if (fresh) {
-            /// Store cursor image into puppet view
-            _puppetCursorView.image = _puppetCursor.image;
-        }
-        
-        /// Draw/move puppet cursor image
-        if (fresh) {
-            /// Draw puppetCursor
-            NSScreen *screenUnderMousePointer = [NSScreen screenUnderMousePointerWithEvent:NULL]; /// We could also use `_display`?
-            [ScreenDrawer.shared drawWithView:_puppetCursorView atFrame:puppetImageFrameUnflipped onScreen:screenUnderMousePointer];
-        } else {
-            /// Reposition  puppet cursor!
-            [ScreenDrawer.shared moveWithView:_puppetCursorView toOrigin:puppetImageFrameUnflipped.origin];
-        }
-        
-        /// Unhide puppet cursor
-        if (fresh) {
-            _puppetCursorView.alphaValue = 1;
-        }
+        /// Draw puppetCursor
+        ///     Undraw first in case the last undraw didn't happen, so we don't leak the sprite.
+        [ScreenDrawer.shared undrawSprite:_puppetCursorSprite];
+        NSScreen *screenUnderMousePointer = [NSScreen screenUnderMousePointerWithEvent:NULL]; /// We could also use `_display`?
+        _puppetCursorSprite = [ScreenDrawer.shared drawSpriteWithImage:_puppetCursor.image atFrame:puppetImageFrameUnflipped onScreen:screenUnderMousePointer];
     };
     
     /// Make sure workload is executed on main thread
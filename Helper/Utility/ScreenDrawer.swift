@@ -13,6 +13,10 @@ import CocoaLumberjackSwift
 @objc class ScreenDrawer: NSObject {
     /// This class can display graphics anywhere on the screen
     /// Based on https://developer.apple.com/library/archive/samplecode/FunkyOverlayWindow/Listings/FunkyOverlayWindow_OverlayWindow_m.html#//apple_ref/doc/uid/DTS10000391-FunkyOverlayWindow_OverlayWindow_m-DontLinkElementID_8
+    ///
+    /// There are two ways to draw:
+    /// - Views: `draw(view:)`, `move(view:)`, `undraw(view:)`. Every call needs to happen on the main thread and goes through AppKit's view machinery. Fine for things that rarely move.
+    /// - Sprites: `drawSprite()`, `moveSprite()`, `undrawSprite()`. A sprite is one of a fixed pool of CALayers inside the layer-backed canvas. `moveSprite()` can be called from any thread and just records the new position in an `OverlayDamageTracker`. On the next display frame, all the changes are applied in a single CATransaction on the displayLink's thread, and if nothing changed, nothing is done. Use this for things that follow the pointer, like the puppet cursor in PointerFreeze.
     
     
     /// Var - Singleton instance
@@ -24,6 +28,17 @@ import CocoaLumberjackSwift
     @objc var canvas: NSWindow = NSWindow()
     /// ^ Need to init this to NSWindow. (Up here not in init()) for things to work. Super strange.
     
+    /// Vars - sprites
+    
+    static let spritePoolSize = 4
+    private var spriteLayers: [CALayer] = []                    /// Only mutate under `spriteLock`
+    private var spriteIsAllocated = [Bool](repeating: false, count: spritePoolSize) /// Main thread only
+    private var damageTracker = OverlayDamageTracker(capacity: spritePoolSize) /// Only access under `spriteLock`
+    private var canvasOrigin: CGPoint = .zero                   /// Screen position of the canvas. Lets `moveSprite()` convert to canvas coordinates without touching the window. Only access under `spriteLock`
+    private var displayLinkIsRunning = false                    /// Only access under `spriteLock`
+    private let spriteLock = NSObject()
+    private let displayLink = DisplayLink(optimizedFor: kMFDisplayLinkWorkTypeGraphicsRendering)
+    
     /// Init
     
     @objc func load_Manual() {
@@ -47,6 +62,9 @@ import CocoaLumberjackSwift
         /// Set contentView
         canvas.contentView = CanvasContent()
         
+        /// Create sprite layers
+        setUpSpriteLayers()
+        
         /// Attempts to fix issue where moving pointer causes CPU load when the canvas is displaying (Ventura Beta)
         ///     -> Doesn't work
         ///     If we fix this, we might also want to update `PointerFreeze.drawPuppetCursor()` to use the "efficient undraw" method
@@ -161,9 +179,170 @@ import CocoaLumberjackSwift
 //        guard let canvas = canvas else { fatalError() }
 //        canvas.orderOut(nil);
         canvas.contentView = CanvasContent()
+        setUpSpriteLayers()
     }
     
+    /// Drawing - sprites
     
+    private func setUpSpriteLayers() {
+        
+        /// Notes:
+        /// - The contentView is layer-backed, and we never let AppKit redraw it. Our sprite layers are plain sublayers which AppKit doesn't know about, so changing them doesn't trigger any view layout or display.
+        /// - We turn off the implicit animations, otherwise every position change would start a 0.25 s animation.
+        
+        guard let content = canvas.contentView else { return }
+        content.wantsLayer = true
+        content.layerContentsRedrawPolicy = .never
+        
+        let noActions: [String: CAAction] = ["position": NSNull(), "bounds": NSNull(), "frame": NSNull(), "contents": NSNull(), "hidden": NSNull()]
+        
+        synchronized(spriteLock) {
+            spriteLayers = (0..<ScreenDrawer.spritePoolSize).map { _ in
+                let layer = CALayer()
+                layer.anchorPoint = .zero
+                layer.isHidden = true
+                layer.actions = noActions
+                content.layer?.addSublayer(layer)
+                return layer
+            }
+            damageTracker = OverlayDamageTracker(capacity: ScreenDrawer.spritePoolSize)
+        }
+        spriteIsAllocated = [Bool](repeating: false, count: ScreenDrawer.spritePoolSize)
+    }
+    
+    @objc func drawSprite(image: NSImage, atFrame frameInScreen: NSRect, onScreen screen: NSScreen) -> Int {
+        
+        /// Returns the sprite index that you can pass to `moveSprite()` and `undrawSprite()`. Returns -1 if all sprites are in use.
+        /// Call this on the main thread.
+        
+        assert(Thread.isMainThread)
+        
+        /// Get free sprite
+        guard let i = spriteIsAllocated.firstIndex(of: false) else {
+            DDLogWarn("ScreenDrawer - All \(ScreenDrawer.spritePoolSize) sprites are in use. Not drawing.")
+            return -1
+        }
+        spriteIsAllocated[i] = true
+        
+        /// Size `canvas` to fill `screen`
+        canvas.setFrame(screen.frame, display: false)
+        let frameInCanvas = canvas.convertFromScreen(frameInScreen)
+        
+        /// Set up layer and show it
+        ///     Applied right away instead of on the next frame, so the sprite doesn't briefly appear at a stale position when the canvas is ordered front.
+        synchronized(spriteLock) {
+            CATransaction.begin()
+            CATransaction.setDisableActions(true)
+            let layer = spriteLayers[i]
+            layer.contentsScale = screen.backingScaleFactor
+            layer.contents = image.layerContents(forContentsScale: screen.backingScaleFactor)
+            canvasOrigin = screen.frame.origin
+            damageTracker.setFrame(frameInCanvas, forSlot: i)
+            damageTracker.setVisible(true, forSlot: i)
+            applySprite_Unsafe(i)
+            CATransaction.commit()
+        }
+        
+        /// Put canvas window on top or sth
+        ///     This is necessary after switching spaces
+        canvas.orderFront(nil)
+        
+        return i
+    }
+    
+    @objc func moveSprite(_ i: Int, toOrigin newOrigin: NSPoint) {
+        
+        /// Can be called from any thread. The move is applied on the next display frame. If you move several times between two frames, only the last move is applied.
+        
+        guard i >= 0 && i < ScreenDrawer.spritePoolSize else { return }
+        
+        let needsStart: Bool = synchronized(spriteLock) {
+            
+            /// Translate screen -> canvas
+            let originInCanvas = CGPoint(x: newOrigin.x - canvasOrigin.x, y: newOrigin.y - canvasOrigin.y)
+            
+            /// Record
+            damageTracker.setOrigin(originInCanvas, forSlot: i)
+            
+            /// Check displayLink
+            let needsStart = !displayLinkIsRunning
+            displayLinkIsRunning = true
+            return needsStart
+        }
+        
+        if needsStart {
+            displayLink.dispatchQueue.async(flags: defaultDFs) {
+                self.displayLink.start_Unsafe(callback: { [unowned self] _ in
+                    self.displayLinkCallback()
+                })
+            }
+        }
+    }
+    
+    @objc func undrawSprite(_ i: Int) {
+        
+        /// Call this on the main thread.
+        
+        assert(Thread.isMainThread)
+        guard i >= 0 && i < ScreenDrawer.spritePoolSize && spriteIsAllocated[i] else { return }
+        spriteIsAllocated[i] = false
+        
+        /// Hide layer
+        let hasVisibleSprites: Bool = synchronized(spriteLock) {
+            CATransaction.begin()
+            CATransaction.setDisableActions(true)
+            damageTracker.setVisible(false, forSlot: i)
+            applySprite_Unsafe(i)
+            spriteLayers[i].contents = nil
+            CATransaction.commit()
+            return damageTracker.hasVisibleSlots
+        }
+        
+        /// Remove canvas
+        ///     Mouse movement causes CPU load while the canvas is open (see `load_Manual()`), so we close it as soon as nothing is displayed.
+        if !hasVisibleSprites && (canvas.contentView?.subviews.isEmpty ?? true) {
+            canvas.isReleasedWhenClosed = false
+            canvas.close()
+        }
+    }
+    
+    private func displayLinkCallback() {
+        
+        /// Runs once per display frame on the displayLink's queue
+        
+        synchronized(spriteLock) {
+            
+            let (changedSlots, shouldStop) = damageTracker.takeUpdate()
+            
+            /// Apply
+            if changedSlots != 0 {
+                CATransaction.begin()
+                CATransaction.setDisableActions(true)
+                var remaining = changedSlots
+                while remaining != 0 {
+                    applySprite_Unsafe(remaining.trailingZeroBitCount)
+                    remaining &= remaining - 1
+                }
+                CATransaction.commit()
+            }
+            
+            /// Stop when idle
+            if shouldStop {
+                displayLinkIsRunning = false
+                displayLink.stop_Unsafe()
+            }
+        }
+    }
+    
+    private func applySprite_Unsafe(_ i: Int) {
+        
+        /// Copy the latest state from the damageTracker to the layer. Call this under `spriteLock` and inside a CATransaction.
+        
+        let slot = damageTracker.slots[i]
+        let layer = spriteLayers[i]
+        layer.frame = slot.frame
+        layer.isHidden = !slot.isVisible
+    }
 }
 
 fileprivate class CanvasContent: NSView {
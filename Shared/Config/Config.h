@@ -34,6 +34,10 @@ void setConfig(NSString *keyPath, NSObject *value);
 void removeFromConfig(NSString *keyPath);
 void commitConfig(void);
 
+/// Propagation
++ (void)applyDelta:(NSDictionary *)delta;
+- (void)flushPendingWrite;
+
 /// Repair
 typedef enum {
     kMFConfigRepairReasonLoad = 0,
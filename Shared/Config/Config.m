@@ -26,6 +26,7 @@
 #import "HelperUtility.h"
 #import "MFMessagePort.h"
 #import "Locator.h"
+#import <sys/file.h>
 
 #if IS_HELPER
 #import "Mac_Mouse_Fix_Helper-Swift.h"
@@ -39,6 +40,14 @@
     
     NSString*_configFilePath; /// Should probably use `Locator.m` to find config and defaultConfig
     NSString *_bundleIDOfAppWhichCausesAppOverride;
+    
+    NSDictionary *_lastCommittedConfig; /// Immutable deep copy of `_config` as of the last commit / load. We diff against this to find out which sections changed. See `commitConfig()`.
+    NSMutableSet<NSString *> *_touchedSections; /// Top-level sections that were written to since the last commit / load. Only these are copied and diffed on commit.
+    BOOL _allSectionsAreTouched; /// Set when `_config` is replaced as a whole
+    dispatch_queue_t _writeQueue;
+    NSDictionary *_pendingWrite; /// Snapshot that's waiting to be written to file. Only access while synchronized on self.
+    NSMutableSet<NSString *> *_pendingSections; /// Top-level sections that changed since the last write. Only access while synchronized on self.
+    BOOL _writeIsScheduled;
 //    NSDictionary *_stringToEventFlagMask; /// Delete this
 }
 @synthesize config=_config, configWithAppOverridesApplied=_configWithAppOverridesApplied;
@@ -73,6 +82,12 @@ static Config *_instance;
         NSURL *applicationSupportURL = [NSFileManager.defaultManager URLForDirectory:NSApplicationSupportDirectory inDomain:NSUserDomainMask appropriateForURL:nil create:NO error:nil];
         NSString *configFilePathRelative = [NSString stringWithFormat:@"%@/config.plist", kMFBundleIDApp];
         _configFilePath = [applicationSupportURL URLByAppendingPathComponent:configFilePathRelative].path;
+        
+        /// Create write queue
+        _writeQueue = dispatch_queue_create("com.nuebling.mac-mouse-fix.config-write", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, -1));
+        
+        /// Init touched sections
+        _touchedSections = [NSMutableSet set];
     }
     return self;
 }
@@ -98,9 +113,27 @@ void setConfig(NSString *keyPath, NSObject *value) {
 #endif
     
     [Config.shared.config setObject:value forCoolKeyPath:keyPath];
+    [Config.shared touchSection:sectionOfKeyPath(keyPath)];
 }
 void removeFromConfig(NSString *keyPath) {
     [Config.shared.config removeObjectForCoolKeyPath:keyPath];
+    [Config.shared touchSection:sectionOfKeyPath(keyPath)];
+}
+
+static NSString *sectionOfKeyPath(NSString *keyPath) {
+    /// The top-level key of a keyPath. Top-level keys never contain (escaped) dots, so we can just split at the first dot.
+    NSUInteger dot = [keyPath rangeOfString:@"."].location;
+    return dot == NSNotFound ? keyPath : [keyPath substringToIndex:dot];
+}
+
+- (void)touchSection:(NSString *)section {
+    [_touchedSections addObject:section];
+}
+
+- (void)setConfig:(NSMutableDictionary *)config {
+    /// Replacing the whole config touches every section
+    _config = config;
+    _allSectionsAreTouched = YES;
 }
 
 static NSURL *defaultConfigURL(void) {
@@ -113,15 +146,104 @@ static NSURL *defaultConfigURL(void) {
 
 void commitConfig(void) {
     /// Convenience function for notifying other modules of the changed config (and writing to file)
+    ///
+    /// Notes:
+    /// - We used to write the whole config to file, send `configFileChanged`, and then both apps would re-read the whole file and reload *all* their derived state. Dragging a slider in the UI commits many times per second, so that was a lot of work. (And reloading the remaps disables addMode in the helper, see `setupFSEventStreamCallback`.)
+    /// - Now we diff the config against the last commit by top-level section (Scroll, Remaps, General, etc.), send only the changed sections to the other app, and only update the derived state that depends on those sections.
+    /// - Writing to file is throttled and happens on a background queue. Use `flushPendingWrite` before reading the file or before the process might go away.
+    /// - Only the changed sections are written to file. See 'Read and write from file'.
+    /// - Only the sections that were written to through `setConfig()` / `removeFromConfig()` since the last commit are copied and diffed. If you mutate a container from the config in place, call `setConfig()` on it afterwards (like RemapTableController does), otherwise the change won't be committed.
+    
+    /// Get changes
+    NSDictionary *snapshot;
+    NSDictionary *delta = [Config.shared deltaSinceLastCommitWithSnapshot:&snapshot];
+    if (delta.count == 0) {
+        DDLogDebug(@"commitConfig: Nothing changed");
+        return;
+    }
+    
+    NSSet<NSString *> *changedSections = [NSSet setWithArray:delta.allKeys];
     
     /// Write to file
-    [Config.shared writeConfigToFile];
+    [Config.shared scheduleWriteToFile:snapshot changedSections:changedSections];
     
     /// Notify other app (mainApp notifies helper, helper notifies mainApp
-    [MFMessagePort sendMessage:@"configFileChanged" withPayload:nil waitForReply:NO];
+    [MFMessagePort sendMessage:@"configDelta" withPayload:delta waitForReply:NO];
     
     /// Update own state
-    [Config updateDerivedStates];
+    [Config updateDerivedStatesForChangedSections:changedSections];
+}
+
+#pragma mark - Delta
+
+static id deepCopy(id plist, CFOptionFlags mutability) {
+    if (plist == nil) return nil;
+    return CFBridgingRelease(CFPropertyListCreateDeepCopy(kCFAllocatorDefault, (__bridge CFPropertyListRef)plist, mutability));
+}
+
+- (NSDictionary *)deltaSinceLastCommitWithSnapshot:(NSDictionary **)snapshotOut {
+    
+    /// Returns the top-level sections that changed since the last commit. Removed sections map to NSNull.
+    /// Also updates `_lastCommittedConfig` and passes out the new snapshot so we don't need to copy twice.
+    ///
+    /// Notes:
+    /// - We only deep-copy and compare the sections in `_touchedSections`. The other sections in the snapshot are shared with the previous snapshot. (They are immutable, so that's safe.)
+    
+    /// Get sections to diff
+    NSSet<NSString *> *sections;
+    if (_allSectionsAreTouched) {
+        NSMutableSet *keys = [NSMutableSet setWithArray:_config.allKeys];
+        [keys addObjectsFromArray:_lastCommittedConfig.allKeys];
+        sections = keys;
+    } else {
+        sections = _touchedSections.copy;
+    }
+    
+    /// Diff
+    NSMutableDictionary *snapshot = [_lastCommittedConfig mutableCopy] ?: [NSMutableDictionary dictionary];
+    NSMutableDictionary *delta = [NSMutableDictionary dictionary];
+    
+    for (NSString *key in sections) {
+        NSObject *new = deepCopy(_config[key], kCFPropertyListImmutable);
+        NSObject *old = _lastCommittedConfig[key];
+        if (new == old || [new isEqual:old]) continue;
+        delta[key] = new ?: NSNull.null;
+        snapshot[key] = new; /// Removes the key if `new` is nil
+    }
+    
+    /// Reset
+    [self markAllSectionsCommitted:snapshot.copy];
+    
+    *snapshotOut = _lastCommittedConfig;
+    return delta;
+}
+
+- (void)markAllSectionsCommitted:(NSDictionary *)lastCommittedConfig {
+    _lastCommittedConfig = lastCommittedConfig;
+    [_touchedSections removeAllObjects];
+    _allSectionsAreTouched = NO;
+}
+
++ (void)applyDelta:(NSDictionary *)delta {
+    
+    /// Applies sections sent by `commitConfig()` from the other app and updates the derived state that depends on them.
+    
+    NSMutableDictionary *newLastCommitted = [self.shared->_lastCommittedConfig mutableCopy] ?: [NSMutableDictionary dictionary];
+    
+    for (NSString *key in delta) {
+        NSObject *value = delta[key];
+        if ([value isEqual:NSNull.null]) {
+            [self.shared.config removeObjectForKey:key];
+            [newLastCommitted removeObjectForKey:key];
+        } else {
+            /// The unarchived payload is immutable, but `setConfig()` expects mutable containers all the way down. (Same as when we load from file)
+            self.shared.config[key] = CFBridgingRelease(CFPropertyListCreateDeepCopy(kCFAllocatorDefault, (__bridge CFPropertyListRef)value, kCFPropertyListMutableContainersAndLeaves));
+            newLastCommitted[key] = value;
+        }
+    }
+    self.shared->_lastCommittedConfig = newLastCommitted.copy;
+    
+    [self updateDerivedStatesForChangedSections:[NSSet setWithArray:delta.allKeys]];
 }
 
 
@@ -130,13 +252,14 @@ void commitConfig(void) {
 + (void)loadFileAndUpdateStates {
     /// Note: This method used to be called `handleConfigFileChange`
     [self.shared loadConfigFromFileAndRepair];
-    [self updateDerivedStates];
+    [self updateDerivedStatesForChangedSections:nil];
 }
 
-+ (void)updateDerivedStates {
++ (void)updateDerivedStatesForChangedSections:(NSSet<NSString *> * _Nullable)sections {
     
     /// Update states across the app that depend on the config.
     /// We should generally call this whenever the config changes.
+    /// Pass nil for `sections` to update everything.
     
 #if IS_MAIN_APP
     [ReactiveConfig.shared reactWithNewConfig:Config.shared.config];
@@ -145,17 +268,28 @@ void commitConfig(void) {
     
 #if IS_HELPER
     
+    /// Define helper
+    ///     AppOverrides can override any section, so we update everything if they change.
+    BOOL everything = sections == nil || [sections containsObject:kMFConfigKeyAppOverrides];
+    BOOL (^changed)(NSString *) = ^BOOL (NSString *section) {
+        return everything || [sections containsObject:section];
+    };
+    
     /// Force update of internal state, (even the active app hastn't changed)
     ///     (Not sure if we need to always do this or only after loading from file)
     [self.shared loadOverridesForApp:@""];
     
     /// Notify other modules
-    [Remap reload];
-    [ScrollConfig reload];
+    ///     Notes:
+    ///     - Keep these dependencies in sync with which sections the modules read from. License, State and Constants are read directly from the config when needed, so there's nothing to update for them.
+    ///     - Remap reads `General.scrollKillSwitch`
+    if (changed(kMFConfigKeyRemaps) || changed(@"General")) [Remap reload];
+    if (changed(kMFConfigKeyScroll))    [ScrollConfig reload];
+    if (changed(kMFConfigKeyScroll) || changed(kMFConfigKeyDeviceProfiles)) [DeviceProfiles reload]; /// After ScrollConfig, since the profiles are applied on top of the `Scroll` section
 //    [Scroll decide];
-    [PointerConfig reload];
-    [GeneralConfig reload];
-    [MenuBarItem reload];
+    if (changed(kMFConfigKeyPointer))   [PointerConfig reload];
+    if (changed(@"General"))            [GeneralConfig reload];
+    if (changed(@"General"))            [MenuBarItem reload];
 
 #endif
     
@@ -314,15 +448,237 @@ void Handle_FSEventStreamCallback(ConstFSEventStreamRef streamRef, void *clientC
 
 #pragma mark - Read and write from file
 
-- (void)writeConfigToFile {
+/// Notes on the file format:
+/// - config.plist is written as a binary plist. NSPropertyListSerialization detects the format when reading, so old XML config files still load fine. To edit the file by hand, convert it with `plutil -convert xml1` or open it in Xcode.
+/// - Rewriting the whole config.plist on every commit is wasteful since most commits only change one section (Dragging a slider only changes `Scroll`). So instead, we append the changed sections to `config.journal` next to config.plist, and only rewrite config.plist ('compact') once the journal grows past `kMFConfigJournalMaxBytes`.
+/// - When loading, we read config.plist and then replay the journal on top of it. (So loading still parses the whole config.plist. Only writing is proportional to the size of the change.)
+///
+/// Notes on crash-safety:
+/// - config.plist is always written atomically.
+/// - Each journal record carries its length and a checksum. If we crash in the middle of appending, the torn record at the end fails the checksum and replay stops there. So we lose at most the last commit.
+/// - The journal header stores a fingerprint (inode, size, modification time) of the config.plist it applies to. Compacting writes a new config.plist, which changes the fingerprint. So if we crash after writing config.plist but before clearing the journal, the stale journal is ignored instead of being replayed onto a config that already contains it. Same thing if config.plist is replaced by hand.
+/// - Both the mainApp and the helper can write. We take an exclusive `flock()` on the journal while appending or compacting, and a shared one while loading, so we never read config.plist and the journal from different generations.
+
+static const uint32_t kMFConfigJournalVersion = 1;
+static const off_t kMFConfigJournalMaxBytes = 128 * 1024;
+
+typedef struct {
+    char magic[4];                  /// "MFCJ"
+    uint32_t version;
+    uint64_t baseFileNumber;        /// Fingerprint of the config.plist that the records apply to
+    uint64_t baseFileSize;
+    int64_t baseModificationTimeNs;
+} MFConfigJournalHeader;
+
+typedef struct {
+    uint32_t length;                /// Length of the serialized record that follows
+    uint32_t checksum;              /// FNV-1a hash of the serialized record
+} MFConfigJournalRecordHeader;
+
+static uint32_t journalChecksum(const uint8_t *bytes, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static BOOL getJournalHeaderForCurrentConfigFile(MFConfigJournalHeader *header) {
+    
+    /// Fills in the header that a journal needs to have to apply to the config.plist that's currently on disk
+    
+    struct stat st;
+    if (stat(Locator.configURL.fileSystemRepresentation, &st) != 0) return NO;
+    
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, "MFCJ", 4);
+    header->version = kMFConfigJournalVersion;
+    header->baseFileNumber = st.st_ino;
+    header->baseFileSize = st.st_size;
+    header->baseModificationTimeNs = (int64_t)st.st_mtimespec.tv_sec * NSEC_PER_SEC + st.st_mtimespec.tv_nsec;
+    return YES;
+}
+
+static int openJournal(int lockType) {
+    
+    /// Opens and locks the journal. Returns -1 on failure. Use `closeJournal()` to unlock and close.
+    
+    int fd = open(Locator.configJournalURL.fileSystemRepresentation, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        DDLogInfo(@"Failed to open config journal. errno: %d", errno); /// Happens on first launch, before the Application Support folder exists
+        return -1;
+    }
+    flock(fd, lockType);
+    return fd;
+}
+
+static void closeJournal(int fd) {
+    if (fd < 0) return;
+    flock(fd, LOCK_UN);
+    close(fd);
+}
+
+- (void)scheduleWriteToFile:(NSDictionary *)snapshot changedSections:(NSSet<NSString *> *)changedSections {
+    
+    /// Writes `snapshot` to file on `_writeQueue` after a short delay. If this is called again before the write happens, only the latest snapshot is written.
+    /// `changedSections` are the top-level keys that changed since the last commit. They are accumulated until the write happens, so the journal record contains everything that changed since the last write.
+    
+    static const double writeDelay = 0.3;
+    
+    @synchronized (self) {
+        _pendingWrite = snapshot;
+        if (_pendingSections == nil) _pendingSections = [NSMutableSet set];
+        [_pendingSections unionSet:changedSections];
+        if (_writeIsScheduled) return;
+        _writeIsScheduled = YES;
+    }
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(writeDelay * NSEC_PER_SEC)), _writeQueue, ^{
+        [self writePendingToFile];
+    });
+}
+
+- (void)flushPendingWrite {
+    
+    /// Synchronously writes the pending snapshot if there is one.
+    
+    dispatch_sync(_writeQueue, ^{
+        [self writePendingToFile];
+    });
+}
+
+- (void)writePendingToFile {
+    
+    NSDictionary *snapshot;
+    NSSet<NSString *> *sections;
+    @synchronized (self) {
+        snapshot = _pendingWrite;
+        sections = _pendingSections;
+        _pendingWrite = nil;
+        _pendingSections = nil;
+        _writeIsScheduled = NO;
+    }
+    
+    if (snapshot == nil) return;
+    
+    /// Try to append to journal. Otherwise compact.
+    BOOL didAppend = [self appendSections:sections ofSnapshot:snapshot];
+    if (!didAppend) {
+        [self compactSections:sections ofSnapshot:snapshot];
+    }
+}
+
+- (BOOL)appendSections:(NSSet<NSString *> *)sections ofSnapshot:(NSDictionary *)snapshot {
+    
+    /// Appends the given sections to the journal. Returns NO if the caller should compact instead. (Because there's no config.plist yet, the journal is full, or something went wrong)
+    
+    if (sections.count == 0) return NO;
+    
+    /// Serialize record
+    ///     Plists can't contain NSNull, so removed sections go into a separate array
+    NSMutableDictionary *set = [NSMutableDictionary dictionary];
+    NSMutableArray *remove = [NSMutableArray array];
+    for (NSString *key in sections) {
+        if (snapshot[key] != nil) set[key] = snapshot[key];
+        else [remove addObject:key];
+    }
+    NSError *serializeErr;
+    NSData *record = [NSPropertyListSerialization dataWithPropertyList:@{ @"set": set, @"remove": remove } format:NSPropertyListBinaryFormat_v1_0 options:0 error:&serializeErr];
+    if (record == nil) {
+        DDLogError(@"Failed to serialize config journal record: %@", serializeErr);
+        return NO;
+    }
+    
+    /// Append
+    int fd = openJournal(LOCK_EX);
+    if (fd < 0) return NO;
+    BOOL success = appendRecordToJournal(fd, record);
+    closeJournal(fd);
+    
+    if (success) {
+        DDLogInfo(@"Appended sections %@ to config journal. (%lu bytes)", sections.allObjects, (unsigned long)record.length);
+    }
+    return success;
+}
+
+static BOOL appendRecordToJournal(int fd, NSData *record) {
+    
+    /// Get expected header
+    MFConfigJournalHeader expectedHeader;
+    if (!getJournalHeaderForCurrentConfigFile(&expectedHeader)) return NO;
+    
+    /// Validate existing header
+    ///     If the journal doesn't belong to the current config.plist, start it over.
+    struct stat st;
+    if (fstat(fd, &st) != 0) return NO;
+    off_t offset = st.st_size;
+    
+    MFConfigJournalHeader existingHeader;
+    BOOL headerIsValid = offset >= (off_t)sizeof(existingHeader)
+                        && pread(fd, &existingHeader, sizeof(existingHeader), 0) == sizeof(existingHeader)
+                        && memcmp(&existingHeader, &expectedHeader, sizeof(expectedHeader)) == 0;
+    if (!headerIsValid) {
+        if (ftruncate(fd, 0) != 0) return NO;
+        if (pwrite(fd, &expectedHeader, sizeof(expectedHeader), 0) != sizeof(expectedHeader)) return NO;
+        offset = sizeof(expectedHeader);
+    }
+    
+    /// Check size
+    if (offset + (off_t)sizeof(MFConfigJournalRecordHeader) + (off_t)record.length > kMFConfigJournalMaxBytes) {
+        DDLogDebug(@"Config journal is full. Compacting.");
+        return NO;
+    }
+    
+    /// Append
+    ///     Write header and record in one call, so a crash can at most leave a torn record at the very end.
+    MFConfigJournalRecordHeader recordHeader = { .length = (uint32_t)record.length, .checksum = journalChecksum(record.bytes, record.length) };
+    NSMutableData *buffer = [NSMutableData dataWithBytes:&recordHeader length:sizeof(recordHeader)];
+    [buffer appendData:record];
+    if (pwrite(fd, buffer.bytes, buffer.length, offset) != (ssize_t)buffer.length) {
+        DDLogError(@"Failed to append to config journal. errno: %d", errno);
+        return NO;
+    }
+    
+    return YES;
+}
+
+- (void)compactSections:(NSSet<NSString *> *)sections ofSnapshot:(NSDictionary *)snapshot {
+    
+    /// Writes the config to config.plist and clears the journal
+    ///
+    /// Notes:
+    /// - We hold the journal lock the whole time, so the other app can't append a record that would then be cleared without being in config.plist.
+    /// - We can't just write `snapshot`. The other app might have appended records for other sections after we took the snapshot, and we'd lose them when clearing the journal. So we re-read what's on disk (config.plist + journal) and only put our own changed `sections` on top of it. That's the same result as appending them would have given.
+    
+    int fd = openJournal(LOCK_EX);
+    
+    NSMutableDictionary *merged = [self readConfigFromFile_Locked:fd];
+    if (merged == nil) {
+        merged = snapshot.mutableCopy; /// There's no config.plist yet
+    } else {
+        for (NSString *key in sections) {
+            merged[key] = snapshot[key]; /// Removes the key if it's not in the snapshot
+        }
+    }
+    
+    [self writeConfigToFile:merged];
+    
+    if (fd >= 0) {
+        ftruncate(fd, 0); /// The header for the new config.plist is written lazily by the next append
+    }
+    closeJournal(fd);
+}
+
+- (void)writeConfigToFile:(NSDictionary *)configDict {
     
     /**
-     Writes the `_config` dicitonary to the plist file at `_configURL`
+     Writes the `configDict` to the plist file at `_configURL`
      You probably want to use `commitConfig()` instead of this
      */
     
     NSError *serializeErr;
-    NSData *configData = [NSPropertyListSerialization dataWithPropertyList:self.config format:NSPropertyListXMLFormat_v1_0 options:0 error:&serializeErr];
+    NSData *configData = [NSPropertyListSerialization dataWithPropertyList:configDict format:NSPropertyListBinaryFormat_v1_0 options:0 error:&serializeErr];
     if (serializeErr) {
         DDLogInfo(@"ERROR serializing configDictFromFile: %@", serializeErr);
     }
@@ -334,26 +690,114 @@ void Handle_FSEventStreamCallback(ConstFSEventStreamRef streamRef, void *clientC
     DDLogInfo(@"Wrote config to file.");
 }
 
-- (void)loadConfigFromFileAndRepair {
+- (NSMutableDictionary *)readConfigFromFile {
     
-    /// Load data from plist file at `_configURL` into `_config` class variable
-    /// This only really needs to be called when `Config` is loaded, but I use it in other places as well, to make the program behave better, when I manually edit the config file.
+    /// Reads config.plist and replays the journal on top of it. Returns nil if there's no config.plist.
+    /// Notes:
+    /// - We map the files instead of reading them into memory. The plist parser only touches the pages it needs.
+    /// - Make sure to `flushPendingWrite` before calling this, otherwise our own latest changes might not be on disk yet.
     
-#if IS_MAIN_APP
-    [self repairConfigWithReason:kMFConfigRepairReasonLoad info:nil];
-#endif
+    int fd = openJournal(LOCK_SH);
+    NSMutableDictionary *configDict = [self readConfigFromFile_Locked:fd];
+    closeJournal(fd);
+    
+    return configDict;
+}
+
+- (NSMutableDictionary *)readConfigFromFile_Locked:(int)fd {
+    
+    /// Does the work for `readConfigFromFile`. The caller needs to hold the journal lock through `fd`, or pass -1 if the journal couldn't be opened.
+    ///     (We can't just take the lock again in here. flock() locks belong to the open file, so opening the journal a second time while holding `LOCK_EX` would block forever.)
     
-    NSData *configData = [NSData dataWithContentsOfURL:Locator.configURL];
+    /// Read config.plist
     NSError *readErr;
-    NSMutableDictionary *configDict = [NSPropertyListSerialization propertyListWithData:configData options:NSPropertyListMutableContainersAndLeaves format:nil error:&readErr];
+    NSData *configData = [NSData dataWithContentsOfURL:Locator.configURL options:NSDataReadingMappedIfSafe error:&readErr];
+    NSMutableDictionary *configDict = nil;
+    if (configData != nil) {
+        configDict = [NSPropertyListSerialization propertyListWithData:configData options:NSPropertyListMutableContainersAndLeaves format:nil error:&readErr];
+    }
     if (readErr) {
         DDLogInfo(@"Error Reading config File: %@", readErr);
         // TODO: handle this error
     }
     
+    /// Replay journal
+    MFConfigJournalHeader expectedHeader;
+    NSData *journal = (fd >= 0) ? [NSData dataWithContentsOfURL:Locator.configJournalURL options:NSDataReadingMappedIfSafe error:nil] : nil;
+    
+    if (configDict != nil && journal.length >= sizeof(MFConfigJournalHeader) && getJournalHeaderForCurrentConfigFile(&expectedHeader)) {
+        
+        const uint8_t *bytes = journal.bytes;
+        
+        if (memcmp(bytes, &expectedHeader, sizeof(expectedHeader)) != 0) {
+            DDLogInfo(@"Config journal doesn't belong to the current config file. Ignoring it.");
+        } else {
+            
+            size_t offset = sizeof(MFConfigJournalHeader);
+            int recordCount = 0;
+            
+            while (offset + sizeof(MFConfigJournalRecordHeader) <= journal.length) {
+                
+                MFConfigJournalRecordHeader recordHeader;
+                memcpy(&recordHeader, bytes + offset, sizeof(recordHeader));
+                offset += sizeof(recordHeader);
+                
+                /// Validate
+                if (offset + recordHeader.length > journal.length || journalChecksum(bytes + offset, recordHeader.length) != recordHeader.checksum) {
+                    DDLogWarn(@"Config journal ends in a torn record after %d records. Ignoring the rest.", recordCount);
+                    break;
+                }
+                
+                /// Apply
+                NSData *recordData = [journal subdataWithRange:NSMakeRange(offset, recordHeader.length)];
+                NSDictionary *record = [NSPropertyListSerialization propertyListWithData:recordData options:NSPropertyListMutableContainersAndLeaves format:nil error:nil];
+                if (![record isKindOfClass:NSDictionary.class]) break;
+                [configDict addEntriesFromDictionary:record[@"set"]];
+                [configDict removeObjectsForKeys:record[@"remove"]];
+                
+                offset += recordHeader.length;
+                recordCount += 1;
+            }
+            
+            DDLogDebug(@"Replayed %d records from config journal", recordCount);
+        }
+    }
+    
+    return configDict;
+}
+
+- (void)loadConfigFromFileAndRepair {
+    
+    /// Load data from plist file at `_configURL` into `_config` class variable
+    /// This only really needs to be called when `Config` is loaded, but I use it in other places as well, to make the program behave better, when I manually edit the config file.
+    
+    /// Make sure the file is up to date
+    ///     Commits only write to file after a delay.
+    [self flushPendingWrite];
+    
+    NSMutableDictionary *configDict = [self readConfigFromFile];
+    
     DDLogDebug(@"Loaded config from file: %@", configDict);
     
     _config = configDict;
+    [self markAllSectionsCommitted:deepCopy(configDict, kCFPropertyListImmutable)];
+    
+#if IS_MAIN_APP
+    /// Repair
+    ///     This works on the config we just loaded, and commits if it changes anything. We used to repair first and then always load the file a second time. Now we only reload if repairing actually committed something.
+    ///     (Reloading makes sure that everything the repair inserted (e.g. from the default config) is mutable all the way down, like the rest of the config.)
+    [self repairConfigWithReason:kMFConfigRepairReasonLoad info:nil];
+    
+    BOOL didRepair;
+    @synchronized (self) {
+        didRepair = _pendingWrite != nil;
+    }
+    if (didRepair) {
+        [self flushPendingWrite];
+        _config = [self readConfigFromFile];
+        [self markAllSectionsCommitted:deepCopy(_config, kCFPropertyListImmutable)];
+    }
+#endif
     
     /// Send reactive signal -> Disabled because callers of this function do that now
 //    [ReactiveConfig.shared reactWithNewConfig:configDict];
@@ -394,8 +838,7 @@ void Handle_FSEventStreamCallback(ConstFSEventStreamRef streamRef, void *clientC
     if (reason == kMFConfigRepairReasonLoad) {
         
         /// Get config dicts
-        /// - We assign to `self.config` here, since repairConfig is called before actually loading `self.config`. Not sure if this is a shitty structure. We're loading the config from file 2x.
-        self.config = [NSMutableDictionary dictionaryWithContentsOfURL:Locator.configURL];
+        /// - `self.config` has just been loaded from file by `loadConfigFromFileAndRepair`
         NSMutableDictionary *defaultConfig = [NSMutableDictionary dictionaryWithContentsOfURL:defaultConfigURL()];
         
         /// Get version objects
@@ -521,6 +964,7 @@ void Handle_FSEventStreamCallback(ConstFSEventStreamRef streamRef, void *clientC
                 [_config setObject:[_config objectForCoolKeyPath:defaultKP] forCoolKeyPath:overrideKP];
             }
         }
+        [self touchSection:kMFConfigKeyAppOverrides];
         commitConfig();
         
     } else {
@@ -557,6 +1001,7 @@ void Handle_FSEventStreamCallback(ConstFSEventStreamRef streamRef, void *clientC
     
     removeLeaflessSubDicts(appOverrides);
     
+    [self touchSection:kMFConfigKeyAppOverrides];
     commitConfig(); /// No need to notify the helper at the time of writing
 }
 
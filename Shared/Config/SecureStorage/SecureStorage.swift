@@ -31,11 +31,35 @@
 /// - Do we user __UserDefaults__?
 ///     - No. config fills the same roll.
 
+/// Caching and batching
+/// - Before, every `get()` read the keychain item and unarchived the whole dict, and every `set()` did that and then archived and replaced the whole item. Every keychain access is an IPC call to securityd.
+/// - Now we keep the decoded dict in memory. It's only re-read from the keychain when the `generation` changed. The generation is bumped whenever any process (mainApp or Helper) writes the item - we find out about that through a Darwin notification, which we can check without any IPC via `notify_check()`.
+/// - The item is synchronizable, so iCloud Keychain can also change it, and we don't get a notification for that. So we also re-read once the cache is older than `maxCacheAge`. (E.g. when the license is activated on another Mac.)
+/// - The keychain read happens outside of `lock`, so other threads' `get()`s aren't stuck behind a slow securityd round trip.
+/// - `set()` updates the in-memory dict right away and records the change. The changes are written on `writeQueue` after a short delay. Multiple `set()`s in a row are written with a single `updateItem()`. When writing, we apply the changes on top of a fresh read of the item, so we don't overwrite changes from the other process.
+/// - Use `flushPendingWrite()` before the process might go away. (Just like `Config.flushPendingWrite()`)
+/// - The keychain access sits behind `SecureStorageBackend`, so you can swap `SecureStorage.backend` for an in-memory store to look at the caching logic or the archiving cost without touching the keychain.
+
 /// TODO: Implement cleanup function. See Notes in NSDictionary+Additions.m for details.
 
 import Foundation
+import QuartzCore
 import CocoaLumberjackSwift
 
+/// Backend
+
+protocol SecureStorageBackend: AnyObject {
+    func readItem() throws -> Data          /// Throws `SecureStorageError.itemNotFound` if there's no item
+    func createItem(data: Data) throws
+    func updateItem(data: Data) throws      /// Throws `SecureStorageError.itemNotFound` if there's no item
+}
+
+enum SecureStorageError: Error {
+    case unhandledError(status: OSStatus)
+    case itemNotFound
+    case invalidItemData
+}
+
 @objc class SecureStorage: NSObject {
     
     /// Surface lvl 2
@@ -45,61 +69,205 @@ import CocoaLumberjackSwift
     }
     
     @objc static func getAll() -> NSDictionary? {
-        do {
-            let dict = try readDict()
-            return dict
-        } catch {
-            return nil
-        }
+        return cachedDict()
     }
     
     /// Surface
     
     @objc static func get(_ keyPath: String) -> Any? {
+        return cachedDict()?.object(forCoolKeyPath: keyPath)
+    }
+    
+    @objc static func set(_ keyPath: String, value: Any?) {
         
-        do {
-            let dict = try readDict()
-            return dict.object(forCoolKeyPath: keyPath)
+        synchronized(lock) {
+            
+            /// Update cache
+            ///     If the cache is outdated, we leave it alone. The next `get()` re-reads and applies `pendingChanges` on top.
+            if let dict = validCache()?.mutableCopy() as? NSMutableDictionary {
+                dict.setObject((value as! NSObject?), forCoolKeyPath: keyPath)
+                cache = (dict.copy() as! NSDictionary)
+            }
+            
+            /// Record change
+            pendingChanges.append((keyPath, value))
+            
+            /// Schedule write
+            if writeIsScheduled { return }
+            writeIsScheduled = true
+            writeQueue.asyncAfter(deadline: .now() + writeDelay) {
+                SecureStorage.writePending()
+            }
+        }
+    }
+    
+    @objc static func flushPendingWrite() {
+        
+        /// Synchronously writes the pending changes if there are any.
+        
+        writeQueue.sync {
+            writePending()
+        }
+    }
+    
+    /// Backend
+    
+    static var backend: SecureStorageBackend = KeychainSecureStorageBackend()
+    
+    /// Cache
+    ///     Only access while holding `lock`
+    
+    private static let lock = NSObject()
+    private static var cache: NSDictionary? = nil
+    private static var cacheGeneration: UInt64 = 0
+    private static var cacheReadAt: CFTimeInterval = 0
+    private static let maxCacheAge: CFTimeInterval = 60
+    private static var generation: UInt64 = 1
+    private static var pendingChanges: [(keyPath: String, value: Any?)] = []
+    private static var writingChanges: [(keyPath: String, value: Any?)] = [] /// Changes that `writePending()` is currently writing
+    private static var writeIsScheduled = false
+    
+    private static let writeQueue = DispatchQueue(label: "com.nuebling.mac-mouse-fix.secure-storage", qos: .utility, attributes: [], autoreleaseFrequency: .inherit, target: nil)
+    private static let writeDelay: DispatchTimeInterval = .milliseconds(300)
+    
+    private static func validCache() -> NSDictionary? {
+        
+        /// Only call while holding `lock`
+        
+        guard let cache = cache else { return nil }
+        if cacheGeneration != Generation.current() { return nil }
+        if CACurrentMediaTime() - cacheReadAt > maxCacheAge { return nil }
+        return cache
+    }
+    
+    private static func cachedDict() -> NSDictionary? {
+        
+        /// Returns the dict from the cache, or reads it from the backend if the cache is outdated.
+        ///     Changes that haven't been written yet are applied on top, so callers always see their own `set()`s.
+        ///     If the item is written while we're reading, we read again, since our read might be from before the write. (At that point the write isn't in `writingChanges` anymore, so we'd lose it.)
+        
+        for _ in 0..<3 {
+            
+            /// Use cache
+            let (cached, generation): (NSDictionary?, UInt64) = synchronized(lock) {
+                (validCache(), Generation.current())
+            }
+            if let cached = cached { return cached }
+            
+            /// Read
+            ///     Outside of `lock`
+            let readAt = CACurrentMediaTime()
+            var dict: NSDictionary
+            do {
+                dict = try readDict()
+            } catch SecureStorageError.itemNotFound {
+                dict = NSDictionary()
+            } catch {
+                return nil
+            }
             
+            /// Store
+            let result: NSDictionary? = synchronized(lock) {
+                
+                if Generation.current() != generation { return nil } /// Item was written while we were reading -> try again
+                
+                if !writingChanges.isEmpty || !pendingChanges.isEmpty {
+                    dict = apply(writingChanges + pendingChanges, to: dict)
+                }
+                cache = dict
+                cacheGeneration = generation
+                cacheReadAt = readAt
+                return dict
+            }
+            if let result = result { return result }
+        }
+        
+        /// Give up on caching
+        ///     The item keeps changing under us. Just return what's there.
+        DDLogWarn("SecureStorage - Item kept changing while reading. Not caching.")
+        var dict: NSDictionary
+        do {
+            dict = try readDict()
+        } catch SecureStorageError.itemNotFound {
+            dict = NSDictionary()
         } catch {
             return nil
         }
+        return synchronized(lock) {
+            if !writingChanges.isEmpty || !pendingChanges.isEmpty {
+                dict = apply(writingChanges + pendingChanges, to: dict)
+            }
+            return dict
+        }
     }
     
-    @objc static func set(_ keyPath: String, value: Any?) {
+    private static func writePending() {
+        
+        /// Only call this on `writeQueue`
         
+        /// Get changes
+        let changes: [(keyPath: String, value: Any?)] = synchronized(lock) {
+            let changes = pendingChanges
+            pendingChanges = []
+            writingChanges = changes
+            writeIsScheduled = false
+            return changes
+        }
+        if changes.isEmpty { return }
+        defer {
+            synchronized(lock) { writingChanges = [] }
+        }
+        
+        /// Write
+        ///     We read fresh from the backend instead of using the cache, so we don't overwrite changes that the other process made since we last read.
         do {
-            let dict = try readDict().mutableCopy() as! NSMutableDictionary
-            dict.setObject((value as! NSObject?), forCoolKeyPath: keyPath)
+            var dict: NSDictionary
+            var itemExists = true
+            do {
+                dict = try readDict()
+            } catch SecureStorageError.itemNotFound {
+                dict = NSDictionary()
+                itemExists = false
+            }
             
-            try replaceDict(dict)
-        
-        } catch KeychainError.itemNotFound {
+            dict = apply(changes, to: dict)
+            let data = try NSKeyedArchiver.archivedData(withRootObject: dict, requiringSecureCoding: false)
             
-            do {
-                try createItem(dict: [:])
-                set(keyPath, value: value)
-                
-            } catch {
-                assert(false)
+            if itemExists {
+                try backend.updateItem(data: data)
+            } else {
+                try backend.createItem(data: data)
             }
             
         } catch {
+            DDLogError("SecureStorage - Failed to write \(changes.count) changes with error: \(error)")
             assert(false)
         }
+        
+        /// Notify other processes
+        ///     This also makes us re-read the item on the next `get()`, which picks up anything the other process wrote in the meantime.
+        Generation.post()
     }
     
     /// Core lvl 2
     
+    private static func apply(_ changes: [(keyPath: String, value: Any?)], to dict: NSDictionary) -> NSDictionary {
+        let result = dict.mutableCopy() as! NSMutableDictionary
+        for (keyPath, value) in changes {
+            result.setObject((value as! NSObject?), forCoolKeyPath: keyPath)
+        }
+        return result.copy() as! NSDictionary
+    }
+    
     private static func readDict() throws -> NSDictionary {
         
-        let data = try readItem()
+        let data = try backend.readItem()
         
         do {
             
             /// Unarchive data into dict
             ///     I think this is secure since other apps can't write to our keychain item.
-            var dict = try SharedUtilitySwift.insecureUnarchive(data: data as Data)
+            var dict = try SharedUtilitySwift.insecureUnarchive(data: data)
             
             /// Catch wrong type
             ///     For some reason I saw the item be a string at some point, causing a crash, so we guard against that here.
@@ -115,51 +283,78 @@ import CocoaLumberjackSwift
             
         } catch {
             assert(false)
-            throw KeychainError.invalidItemData
+            throw SecureStorageError.invalidItemData
         }
     }
     
-    private static func replaceDict(_ dict: NSDictionary) throws {
-        
-        let data = try NSKeyedArchiver.archivedData(withRootObject: dict, requiringSecureCoding: false)
-        try updateItem(data: data as CFData)
-    }
+    /// Generation
+    ///     Notes:
+    ///     - `notify_check()` reads a shared memory page, so it's cheap enough to call on every `get()`.
+    ///     - It also reports a change on the first call after registering, so the first `get()` always reads from the backend.
     
-    private static func createItem(dict: NSDictionary) throws {
+    private enum Generation {
+        
+        static let notificationName = "com.nuebling.mac-mouse-fix.secure-storage.changed"
+        
+        private static var token: Int32 = {
+            var token: Int32 = NOTIFY_TOKEN_INVALID
+            let status = notify_register_check(notificationName, &token)
+            if status != NOTIFY_STATUS_OK {
+                DDLogWarn("SecureStorage - Failed to register for change notifications. Status: \(status). Not caching.")
+            }
+            return token
+        }()
+        
+        static func current() -> UInt64 {
+            
+            /// Only call while holding `lock`
+            
+            var changed: Int32 = 0
+            let status = notify_check(token, &changed)
+            if status != NOTIFY_STATUS_OK || changed != 0 {
+                SecureStorage.generation &+= 1
+            }
+            return SecureStorage.generation
+        }
         
-        let data = try NSKeyedArchiver.archivedData(withRootObject: dict, requiringSecureCoding: false)
-        try createItem(data: data as CFData)
+        static func post() {
+            notify_post(notificationName)
+        }
     }
+}
+
+/// Keychain backend
+
+class KeychainSecureStorageBackend: SecureStorageBackend {
     
-    /// Core lvl 1
-    
-    private static func createItem(data: CFData) throws {
+    func createItem(data: Data) throws {
         
         /// Note: The docs say to use SecItemAdd() from a background thread since it blocks the calling thread, but it seems fine so far.
+        ///     Edit: Writes now happen on `SecureStorage.writeQueue`.
         
         var query = baseQuery()
-        query[kSecValueData as String] = data
+        query[kSecValueData as String] = data as CFData
         
         let status = SecItemAdd(query as CFDictionary, nil)
 
-        guard status == errSecSuccess else { throw KeychainError.unhandledError(status: status) }
+        guard status == errSecSuccess else { throw SecureStorageError.unhandledError(status: status) }
     }
     
-    private static func updateItem(data: CFData) throws {
+    func updateItem(data: Data) throws {
         
         let query = baseQuery()
         
         let updates = [
-            kSecValueData as String: data
+            kSecValueData as String: data as CFData
         ]
         
         let status = SecItemUpdate(query as CFDictionary, updates as CFDictionary)
         
-        guard status != errSecItemNotFound else { throw KeychainError.itemNotFound }
-        guard status == errSecSuccess else { throw KeychainError.unhandledError(status: status) }
+        guard status != errSecItemNotFound else { throw SecureStorageError.itemNotFound }
+        guard status == errSecSuccess else { throw SecureStorageError.unhandledError(status: status) }
     }
     
-    private static func readItem() throws -> CFData {
+    func readItem() throws -> Data {
         
         var query = baseQuery()
         query[kSecReturnData as String] = kCFBooleanTrue!
@@ -167,39 +362,31 @@ import CocoaLumberjackSwift
         var item: CFTypeRef?
         let status = SecItemCopyMatching(query as CFDictionary, &item)
         
-        guard status != errSecItemNotFound else { throw KeychainError.itemNotFound }
-        guard status == errSecSuccess else { throw KeychainError.unhandledError(status: status) }
+        guard status != errSecItemNotFound else { throw SecureStorageError.itemNotFound }
+        guard status == errSecSuccess else { throw SecureStorageError.unhandledError(status: status) }
         
         guard
             let item = item,
             CFGetTypeID(item) == CFDataGetTypeID()
         else {
-            throw KeychainError.invalidItemData
+            throw SecureStorageError.invalidItemData
         }
         
-        return item as! CFData
+        return (item as! CFData) as Data
     }
     
     /// Core lvl 0
     
     private static let label = "com.nuebling.mac-mouse-fix.secure-storage" /// "MFSecureStorage"
     
-    private static func baseQuery() -> [String: Any] {
+    private func baseQuery() -> [String: Any] {
         
         let query: [String: Any] = [
             kSecAttrSynchronizable as String: kCFBooleanTrue!,
             kSecClass as String: kSecClassGenericPassword,
-            kSecAttrLabel as String: label,
+            kSecAttrLabel as String: KeychainSecureStorageBackend.label,
         ]
         
         return query
     }
-    
-    /// Define errors
-    
-    private enum KeychainError: Error {
-        case unhandledError(status: OSStatus)
-        case itemNotFound
-        case invalidItemData
-    }
 }
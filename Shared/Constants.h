@@ -112,6 +112,7 @@ typedef NSString*                                                       MFString
 #define kMFConfigKeyPointer @"Pointer"
 #define kMFConfigKeyOther @"Other" // TODO: This occurs in keypaths a few times - replace with constant (search for 'Other.')
 #define kMFConfigKeyAppOverrides @"AppOverrides"
+#define kMFConfigKeyDeviceProfiles @"DeviceProfiles" /// Not part of default_config.plist. See DeviceProfiles.swift
 
 #pragma mark - Remaps array
 // (^ Reuses many keys defined under "Remaps dict")
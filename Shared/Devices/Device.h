@@ -9,12 +9,14 @@
 
 #import <Foundation/Foundation.h>
 #import <IOKit/hid/IOHIDManager.h>
+#import "DeviceRegistry.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface Device : NSObject
 
 @property (atomic, assign, readonly, nullable) IOHIDDeviceRef iohidDevice;
+@property (atomic, assign) int deviceIndex; /// Small integer that's stable while the device is attached. Can be used as an array index. Assigned by DeviceManager. `kMFDeviceIndexNone` if the device isn't attached.
 
 + (instancetype)new NS_UNAVAILABLE;
 
@@ -26,6 +28,9 @@ NS_ASSUME_NONNULL_BEGIN
 - (BOOL)wrapsIOHIDDevice:(IOHIDDeviceRef)iohidDevice;
 - (NSString *)name;
 - (NSString *)manufacturer;
+- (NSNumber * _Nullable)vendorID;
+- (NSNumber * _Nullable)productID;
+- (NSString * _Nullable)serialNumber;
 - (int)nOfButtons;
 - (NSString *)description;
 
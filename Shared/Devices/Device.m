@@ -39,6 +39,7 @@
 - (Device *)init { /// This is just so that StrangeDevice works.
     self->_nOfButtons = 0;
     self->_iohidDevice = nil;
+    self->_deviceIndex = kMFDeviceIndexNone;
     return [super init];
 }
 + (Device *)strangeDevice {
@@ -95,6 +96,9 @@
         _iohidDevice = IOHIDDevice;
         CFRetain(_iohidDevice);
         
+        /// Not attached, yet
+        _deviceIndex = kMFDeviceIndexNone;
+        
         /// Open device
         ///     This seems to be necessary in the Ventura Beta.
         ///     See https://github.com/noah-nuebling/mac-mouse-fix/issues/297. And thanks to @chamburr!!
@@ -295,6 +299,20 @@ static void handleInput(void *context, IOReturn result, void *sender, IOHIDValue
     return manufacturer;
 }
 
+- (NSNumber * _Nullable)vendorID {
+    return IOHIDDeviceGetProperty(self.iohidDevice, CFSTR(kIOHIDVendorIDKey));
+}
+
+- (NSNumber * _Nullable)productID {
+    return IOHIDDeviceGetProperty(self.iohidDevice, CFSTR(kIOHIDProductIDKey));
+}
+
+- (NSString * _Nullable)serialNumber {
+    /// Many mice don't report a serial number. Some report an empty string.
+    NSString *serial = IOHIDDeviceGetProperty(self.iohidDevice, CFSTR(kIOHIDSerialNumberKey));
+    return serial.length > 0 ? serial : nil;
+}
+
 - (int)nOfButtons {
     return self->_nOfButtons;
 }
@@ -427,6 +445,18 @@ static uint64_t IOHIDDeviceGetRegistryID(IOHIDDeviceRef  _Nonnull device) {
     return @"Unknown Manufacturer";
 }
 
+- (NSNumber * _Nullable)vendorID {
+    return nil;
+}
+
+- (NSNumber * _Nullable)productID {
+    return nil;
+}
+
+- (NSString * _Nullable)serialNumber {
+    return nil;
+}
+
 - (int)nOfButtons {
     return 0;
 }
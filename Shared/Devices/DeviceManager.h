@@ -25,6 +25,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (BOOL)devicesAreAttached;
 + (Device * _Nullable)attachedDeviceWithIOHIDDevice:(IOHIDDeviceRef)iohidDevice;
++ (Device * _Nullable)attachedDeviceWithIndex:(int)index; /// See `Device.deviceIndex`
 
 + (BOOL)someDeviceHasScrollWheel;
 + (BOOL)someDeviceHasPointing;
@@ -40,8 +40,14 @@
 static IOHIDManagerRef _manager;
 static NSMutableArray<Device *> *_attachedDevices;
 
+/// Registry
+///     Assigns each attached device a stable index and keeps count of what the attached devices can do. See DeviceRegistry.m.
+///     `_devicesByIndex` holds the Device for each used index of the registry.
+static MFDeviceRegistry _registry;
+static Device *_devicesByIndex[kMFDeviceRegistryCapacity];
+
 + (BOOL)devicesAreAttached {
-    return _attachedDevices.count > 0;
+    return MFDeviceRegistryHasDevices(&_registry);
 }
 + (NSArray<Device *> *)attachedDevices {
     return _attachedDevices;
@@ -50,40 +56,21 @@ static NSMutableArray<Device *> *_attachedDevices;
     return _attachedDevices;
 }
 
-static NSMutableDictionary<NSNumber *, Device *> *_iohidToAttachedCache;
++ (Device * _Nullable)attachedDeviceWithIndex:(int)index {
+    if (index < 0 || index >= kMFDeviceRegistryCapacity) return nil;
+    return _devicesByIndex[index];
+}
+
 + (Device * _Nullable)attachedDeviceWithIOHIDDevice:(IOHIDDeviceRef)iohidDevice {
     
-    /// NOTE: Tried caching here using `_iohidToAttachedCache`, but it actually makes things slower.
-    /// TODO: Remove caching
-    
-//    if (_iohidToAttachedCache == nil) {
-//        _iohidToAttachedCache = [NSMutableDictionary dictionary];
-//    }
-//
-//    NSNumber *key = (__bridge NSNumber *)IOHIDDeviceGetProperty(iohidDevice, CFSTR(kIOHIDUniqueIDKey));
-//
-//    Device *fromCache = _iohidToAttachedCache[key];
-//
-//    if (fromCache != nil) {
-//        return fromCache;
-//    } else {
-//
-        Device *result = nil;
-        
-        for (Device *device in _attachedDevices) {
-            if ([device wrapsIOHIDDevice:iohidDevice]) {
-                result = device;
-                break;
-            }
-        }
-        
-//        if (result != nil && key != nil) {
-//            [_iohidToAttachedCache setObject:result forKey:key];
-//        }
-        return result;
-//    }
+    /// NOTE: Tried caching here using an `_iohidToAttachedCache` dictionary, but it actually made things slower. Now we look up the uniqueID in the registry, which is a few integer compares, and avoids going through NSNumber.
     
-
+    uint64_t uniqueID;
+    if (!getUniqueID(iohidDevice, &uniqueID)) {
+        return nil;
+    }
+    int index = MFDeviceRegistryIndexOfUniqueID(&_registry, uniqueID);
+    return [self attachedDeviceWithIndex:index];
 }
 
 # pragma mark - Lifecycle
@@ -128,37 +115,19 @@ static NSMutableDictionary<NSNumber *, Device *> *_iohidToAttachedCache;
 #pragma mark - Device information
 
 + (BOOL)someDeviceHasScrollWheel {
-    return _attachedDevices.count > 0;
+    return MFDeviceRegistryHasScrollWheel(&_registry);
 }
 
 + (BOOL)someDeviceHasPointing {
-    return _attachedDevices.count > 0;
+    return MFDeviceRegistryHasPointing(&_registry);
 }
 + (BOOL)someDeviceHasUsableButtons {
     /// We ignore MB 1 and MB 2. That's also why it's called "deviceHas**Usable**Buttons", and not just "deviceHasButtons"
-    return self.maxButtonNumberAmongDevices > 2;
+    return MFDeviceRegistryHasUsableButtons(&_registry);
 }
 
-static BOOL _maxButtonNumberAmongDevices_IsCached = false;
 + (int)maxButtonNumberAmongDevices {
-    
-    static MFMouseButtonNumber _result = 0;
-    
-    if (_maxButtonNumberAmongDevices_IsCached) {
-        return _result;
-    } else {
-        
-        _result = 0;
-        for (Device *device in _attachedDevices) {
-            int b = device.nOfButtons;
-            if (b > _result) {
-                _result = b;
-            }
-        }
-        
-        _maxButtonNumberAmongDevices_IsCached = true;
-        return _result;
-    }
+    return MFDeviceRegistryMaxButtonNumber(&_registry);
 }
 
 # pragma mark - Setup callbacks
@@ -221,15 +190,42 @@ static void handleDeviceMatching(void *context, IOReturn result, void *sender, I
         
         /// Attach
         
+        /// Get uniqueID
+        ///     Before creating the Device instance, because that opens the IOHIDDevice.
+        uint64_t uniqueID;
+        if (!getUniqueID(device, &uniqueID)) {
+            DDLogError(@"Matching IOHIDDevice has neither a uniqueID nor a registryEntryID. Not attaching it.");
+            return;
+        }
+        if (MFDeviceRegistryIndexOfUniqueID(&_registry, uniqueID) != kMFDeviceIndexNone) {
+            DDLogWarn(@"Matching IOHIDDevice is already attached. Not attaching it again."); /// Don't open (and later close) it a second time - it's the same device the attached Device instance has open.
+            return;
+        }
+        
         /// Create Device instance
         Device *newDevice = [Device deviceWithIOHIDDevice:device];
         
+        /// Add to registry
+        ///     We only match mice (see `setupDeviceMatchingAndRemovalCallbacks()`), and we've always assumed that those can scroll and point. So we don't check the elements for that.
+        MFDeviceCapabilities capabilities = {
+            .hasScrollWheel = true,
+            .hasPointing = true,
+            .nOfButtons = newDevice.nOfButtons,
+        };
+        int index = MFDeviceRegistryAdd(&_registry, uniqueID, capabilities);
+        if (index == kMFDeviceIndexNone) {
+            DDLogError(@"Couldn't add device to registry. There are more than %d devices attached. Not attaching it.", kMFDeviceRegistryCapacity);
+            IOHIDDeviceClose(newDevice.iohidDevice, kIOHIDOptionsTypeNone); /// Undo the `IOHIDDeviceOpen()` from `deviceWithIOHIDDevice:`
+            return;
+        }
+        newDevice.deviceIndex = index;
+        _devicesByIndex[index] = newDevice;
+        
+        /// Resolve per-device settings
+        [DeviceProfiles deviceAttached:newDevice];
+        
         /// Add to attachedDevices list
         [_attachedDevices addObject:newDevice];
-//        [_iohidToAttachedCache removeAllObjects];
-        
-        /// Reset cache
-        _maxButtonNumberAmongDevices_IsCached = false;
         
         /// Notify
 //        [ReactiveDeviceManager.shared handleAttachedDevicesDidChange];
@@ -291,13 +287,13 @@ static void handleDeviceRemoval(void *context, IOReturn result, void *sender, IO
     } else {
         
         /// Remove
+        int index = attachedDevice.deviceIndex;
+        [DeviceProfiles deviceRemoved:attachedDevice];
+        MFDeviceRegistryRemove(&_registry, index);
+        _devicesByIndex[index] = nil;
+        attachedDevice.deviceIndex = kMFDeviceIndexNone;
         [_attachedDevices removeObject:attachedDevice];
         
-        /// Reset cache
-        
-        _maxButtonNumberAmongDevices_IsCached = false;
-        [_iohidToAttachedCache removeAllObjects];
-        
         /// Notify
 //        [ReactiveDeviceManager.shared handleAttachedDevicesDidChange];
         [SwitchMaster.shared attachedDevicesChangedWithDevices:_attachedDevices];
@@ -316,6 +312,24 @@ static void handleDeviceRemoval(void *context, IOReturn result, void *sender, IO
 
 # pragma mark - Helper Functions
 
+static BOOL getUniqueID(IOHIDDeviceRef device, uint64_t *outUniqueID) {
+    
+    /// Same ID that `-[Device uniqueID]` and `-[Device wrapsIOHIDDevice:]` use
+    ///     If a device doesn't have `kIOHIDUniqueIDKey`, we fall back to the registryEntryID of its service. That's what IOKit fills `kIOHIDUniqueIDKey` with in the first place, so the two can't collide.
+    ///     Before the DeviceRegistry, devices without uniqueID were still attached (they just could never be found by `attachedDeviceWithIOHIDDevice:`). The fallback keeps attaching them, and now removal works for them, too.
+    
+    CFTypeRef value = IOHIDDeviceGetProperty(device, CFSTR(kIOHIDUniqueIDKey));
+    if (value != NULL && CFGetTypeID(value) == CFNumberGetTypeID()) {
+        return CFNumberGetValue((CFNumberRef)value, kCFNumberSInt64Type, outUniqueID);
+    }
+    
+    io_service_t service = IOHIDDeviceGetService(device);
+    if (service == MACH_PORT_NULL) {
+        return NO;
+    }
+    return IORegistryEntryGetRegistryEntryID(service, outUniqueID) == KERN_SUCCESS;
+}
+
 static BOOL devicePassesFiltering(IOHIDDeviceRef device) {
     /// Helper function for handleDeviceMatching()
     
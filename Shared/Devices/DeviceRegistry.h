@@ -0,0 +1,66 @@
+//
+// --------------------------------------------------------------------------
+// DeviceRegistry.h
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Bookkeeping for the attached devices: Which device has which index, and what the attached devices can do all together. See DeviceRegistry.m for discussion.
+
+#import <stdbool.h>
+#import <stdint.h>
+
+#pragma mark - Constants
+
+#define kMFDeviceRegistryCapacity 32    /// Limited by the `usedSlots` bitmask
+#define kMFDeviceIndexNone (-1)         /// Index of devices that aren't in the registry (e.g. `StrangeDevice`, or any `Device` in the mainApp)
+#define kMFDeviceRegistryMaxButtonNumber 63 /// Limited by the `buttonNumbers` bitmask. Larger button counts are clamped.
+
+#pragma mark - Types
+
+typedef struct {
+    bool hasScrollWheel;
+    bool hasPointing;
+    int nOfButtons;
+} MFDeviceCapabilities;
+
+typedef struct {
+    
+    /// Slots
+    uint32_t usedSlots;                                             /// Bit i is set if index i is taken
+    uint64_t uniqueIDs[kMFDeviceRegistryCapacity];                  /// `kIOHIDUniqueIDKey` of the device at each index
+    MFDeviceCapabilities capabilities[kMFDeviceRegistryCapacity];
+    
+    /// Counters
+    int nOfDevices;
+    int nWithScrollWheel;
+    int nWithPointing;
+    int nWithUsableButtons;
+    uint16_t nWithButtonNumber[kMFDeviceRegistryMaxButtonNumber + 1]; /// Histogram of `nOfButtons`
+    uint64_t buttonNumbers;                                         /// Bit n is set if `nWithButtonNumber[n] > 0`
+    
+} MFDeviceRegistry;
+
+#pragma mark - Adding and removing
+
+/// Returns the index of the new device, or `kMFDeviceIndexNone` if the registry is full or the device is already in it.
+int MFDeviceRegistryAdd(MFDeviceRegistry *registry, uint64_t uniqueID, MFDeviceCapabilities capabilities);
+/// Returns false if there's no device at `index`.
+bool MFDeviceRegistryRemove(MFDeviceRegistry *registry, int index);
+
+#pragma mark - Lookup
+
+/// Returns `kMFDeviceIndexNone` if there's no such device.
+int MFDeviceRegistryIndexOfUniqueID(const MFDeviceRegistry *registry, uint64_t uniqueID);
+
+#pragma mark - Queries
+
+static inline bool MFDeviceRegistryHasDevices(const MFDeviceRegistry *registry)         { return registry->nOfDevices > 0; }
+static inline bool MFDeviceRegistryHasScrollWheel(const MFDeviceRegistry *registry)     { return registry->nWithScrollWheel > 0; }
+static inline bool MFDeviceRegistryHasPointing(const MFDeviceRegistry *registry)        { return registry->nWithPointing > 0; }
+static inline bool MFDeviceRegistryHasUsableButtons(const MFDeviceRegistry *registry)   { return registry->nWithUsableButtons > 0; }
+static inline int MFDeviceRegistryMaxButtonNumber(const MFDeviceRegistry *registry) {
+    return registry->buttonNumbers == 0 ? 0 : 63 - __builtin_clzll(registry->buttonNumbers);
+}
@@ -0,0 +1,123 @@
+//
+// --------------------------------------------------------------------------
+// DeviceRegistry.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Why:
+///     `DeviceManager` used to answer `someDeviceHasUsableButtons`, `maxButtonNumberAmongDevices`, etc. by iterating over all attached devices, with a cache flag for the max button number that was reset on every attach / detach. And `attachedDeviceWithIOHIDDevice:` (which ButtonInputReceiver calls for every button event) compared the uniqueID NSNumbers of all attached devices. There was also an `_iohidToAttachedCache` dictionary which didn't help and was mostly commented out.
+///     We also want to keep per-device state in the scroll, click and pointer code at some point. For that, it's much nicer to have a small integer per device that can be used as an index into a plain C array, instead of keying dictionaries with Device objects.
+///
+/// How:
+///     - Each device gets the lowest free index in a fixed number of slots. The index stays the same until the device is removed, after which it can be reused by the next device that's attached.
+///     - The capability counters are updated when a device is added or removed. So the queries in the header are just a comparison.
+///     - To get the max button number without iterating, we keep a histogram of button counts plus a bitmask of which counts are non-empty. The max is the highest set bit.
+///
+/// Notes:
+///     - This is plain C without any dependencies on IOKit or Foundation. DeviceManager translates between `Device` / `IOHIDDeviceRef` and this.
+///     - Not synchronized. DeviceManager only changes it from the IOHIDManager callbacks on the main thread. (Same as `_attachedDevices` before.)
+
+#import "DeviceRegistry.h"
+#import <string.h>
+#import <assert.h>
+
+#pragma mark - Helper
+
+static inline int clampedButtonNumber(int nOfButtons) {
+    if (nOfButtons < 0) return 0;
+    if (nOfButtons > kMFDeviceRegistryMaxButtonNumber) return kMFDeviceRegistryMaxButtonNumber;
+    return nOfButtons;
+}
+
+static inline bool hasUsableButtons(MFDeviceCapabilities capabilities) {
+    /// We ignore MB 1 and MB 2. That's also why it's called "**usable** buttons", and not just "buttons"
+    return capabilities.nOfButtons > 2;
+}
+
+static inline bool indexIsUsed(const MFDeviceRegistry *registry, int index) {
+    return index >= 0 && index < kMFDeviceRegistryCapacity && (registry->usedSlots & (1u << index)) != 0;
+}
+
+#pragma mark - Adding and removing
+
+int MFDeviceRegistryAdd(MFDeviceRegistry *registry, uint64_t uniqueID, MFDeviceCapabilities capabilities) {
+    
+    /// Check duplicate
+    ///     The IOHIDManager shouldn't report the same device twice without removing it in between, but if it does, we don't want to count it twice.
+    if (MFDeviceRegistryIndexOfUniqueID(registry, uniqueID) != kMFDeviceIndexNone) {
+        return kMFDeviceIndexNone;
+    }
+    
+    /// Find free slot
+    uint32_t freeSlots = ~registry->usedSlots;
+    if (freeSlots == 0) {
+        return kMFDeviceIndexNone;
+    }
+    int index = __builtin_ctz(freeSlots);
+    
+    /// Store
+    registry->usedSlots |= (1u << index);
+    registry->uniqueIDs[index] = uniqueID;
+    registry->capabilities[index] = capabilities;
+    
+    /// Update counters
+    registry->nOfDevices += 1;
+    if (capabilities.hasScrollWheel)    registry->nWithScrollWheel += 1;
+    if (capabilities.hasPointing)       registry->nWithPointing += 1;
+    if (hasUsableButtons(capabilities)) registry->nWithUsableButtons += 1;
+    
+    int b = clampedButtonNumber(capabilities.nOfButtons);
+    registry->nWithButtonNumber[b] += 1;
+    registry->buttonNumbers |= (1ull << b);
+    
+    return index;
+}
+
+bool MFDeviceRegistryRemove(MFDeviceRegistry *registry, int index) {
+    
+    if (!indexIsUsed(registry, index)) {
+        return false;
+    }
+    
+    MFDeviceCapabilities capabilities = registry->capabilities[index];
+    
+    /// Update counters
+    registry->nOfDevices -= 1;
+    if (capabilities.hasScrollWheel)    registry->nWithScrollWheel -= 1;
+    if (capabilities.hasPointing)       registry->nWithPointing -= 1;
+    if (hasUsableButtons(capabilities)) registry->nWithUsableButtons -= 1;
+    
+    int b = clampedButtonNumber(capabilities.nOfButtons);
+    assert(registry->nWithButtonNumber[b] > 0);
+    registry->nWithButtonNumber[b] -= 1;
+    if (registry->nWithButtonNumber[b] == 0) {
+        registry->buttonNumbers &= ~(1ull << b);
+    }
+    
+    /// Clear slot
+    registry->usedSlots &= ~(1u << index);
+    registry->uniqueIDs[index] = 0;
+    memset(&registry->capabilities[index], 0, sizeof(MFDeviceCapabilities));
+    
+    return true;
+}
+
+#pragma mark - Lookup
+
+int MFDeviceRegistryIndexOfUniqueID(const MFDeviceRegistry *registry, uint64_t uniqueID) {
+    
+    /// Just a linear search over the used slots. There's rarely more than 1 or 2 devices attached, so this is a handful of integer compares.
+    
+    uint32_t remaining = registry->usedSlots;
+    while (remaining != 0) {
+        int i = __builtin_ctz(remaining);
+        remaining &= remaining - 1;
+        if (registry->uniqueIDs[i] == uniqueID) {
+            return i;
+        }
+    }
+    return kMFDeviceIndexNone;
+}
@@ -16,6 +16,8 @@ NS_ASSUME_NONNULL_BEGIN
 + (void)disableHelperFromHelper;
 
 + (BOOL)helperIsActive;
++ (void)probeHelperStateInBackground;
++ (void)helperDidReportEnabled:(BOOL)enabled payload:(NSDictionary *_Nullable)payload;
 + (void)enableHelperAsUserAgent:(BOOL)enable onComplete:(void (^ _Nullable)(NSError * _Nullable error))onComplete NS_SWIFT_NAME(enableHelperAsUserAgent(_:onComplete:));
 
 + (void)killAllHelpers;
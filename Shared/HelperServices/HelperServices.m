@@ -61,10 +61,14 @@
 #import "Locator.h"
 #import "SharedUtility.h"
 #import "MFMessagePort.h"
+#import "Config.h"
 #import <ServiceManagement/ServiceManagement.h>
 #import <sys/sysctl.h>
 #import <sys/types.h>
 #import "MFMessagePort.h"
+#import "LaunchctlParser.h"
+#import "MFSharedStatus.h"
+#import <libproc.h>
 
 #if IS_MAIN_APP
 #import "Mac_Mouse_Fix-Swift.h"
@@ -88,8 +92,9 @@
     ///     Send method to helper to ask if it's active.
     ///     Also checks that the connected helper's bundle version matches the main app's bundle version and returns that the helper is inactive if not. This circumvents issues where the main app would think it's enabled when being started while an old incompatible helper instance is still running
     ///     TODO: If an old, incompatible helper is still running - disable it
+    ///     Edit: We now cache the result of the message. See `Helper state cache` below.
 
-    return [self helperIsActive_Message];
+    return helperIsActive_Cached();
 
     /// Old method
     ///     Ask launchd apis whether helper is active.
@@ -139,6 +144,16 @@
     /// I refactored HelperServices, which is very dangerous. Haven't tested it properly at the time of writing, especially pre-Ventura.
     ///     I think 07e861de4504daad9996a40ce32c4aea5c87552a is the last commit before the changes.
     
+    /// Write config
+    ///     The helper reads the config from file when it starts, and `commitConfig()` writes to file after a delay.
+    if (enable) {
+        [Config.shared flushPendingWrite];
+    }
+    
+    /// Invalidate helper state cache
+    ///     The helper is about to be started or stopped. We'll learn the new state from the `helperEnabled` message, or from the exit of the helper process.
+    invalidateHelperState();
+    
     if (@available(macOS 13.0, *)) {
         
         dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0), ^{
@@ -330,6 +345,253 @@
 ///
 ///
 ///
+#pragma mark Helper state cache
+
+/// Cache for `helperIsActive`
+///
+/// Why:
+///     `helperIsActive` is called by the UI (e.g. EnabledState, TabViewController) on the main thread. Before, each call did a message port round trip to the helper which blocks until the helper replies or the message times out.
+///
+/// How:
+///     - We ask the helper once (`helperInfo_Message`) and cache the answer. After that the state is only changed by pushes:
+///         - The helper sends `helperEnabled` when it starts, and `helperDisabled` when it's disabled from the helper side. MFMessagePort forwards those to `helperDidReportEnabled:payload:`.
+///         - When the helper is active, we watch its process with a dispatch source, so we notice when it quits or crashes without having to poll. (That's why we didn't go with a periodic heartbeat - a dead helper can't send a 'stopped' heartbeat anyways, so we'd have to poll with timeouts.)
+///         - When the mainApp itself enables or disables the helper, the state is invalidated and the next call asks again.
+///     - While the state is unknown, `helperIsActive` starts asking in the background and returns the last state it knew. When the answer arrives and differs from that, we tell `EnabledState`, the same way MFMessagePort does when the helper reports itself enabled/disabled. (That way the main thread doesn't block on the message port, which can take up to its 1 s receive timeout if the helper is stuck.)
+///     - Exception: Before we've ever known the state, there's no 'last state' to return. So the first calls wait for the probe, but at most `kMFFirstHelperProbeTimeout`. Otherwise, the UI would treat an enabled app as disabled during launch. (E.g. TabViewController would restore the general tab instead of the saved tab.) The probe usually answers from the shared status block (See `helperInfo_Message`), so this rarely takes more than a few ms.
+///     - `probeHelperStateInBackground` asks the helper on a background queue. The mainApp calls it on startup, so the first `helperIsActive` call usually already gets the real answer.
+///
+/// Notes:
+///     - All state is only accessed on `helperStateQueue()`.
+
+typedef enum {
+    kMFHelperStateUnknown,
+    kMFHelperStateActive,
+    kMFHelperStateInactive,
+} MFHelperState;
+
+#define kMFFirstHelperProbeTimeout 0.5 /// Seconds
+
+static MFHelperState _helperState = kMFHelperStateUnknown;
+static BOOL _helperWasLastKnownActive = NO; /// What we return while `_helperState` is unknown
+static BOOL _helperStateWasEverKnown = NO; /// If this is NO, `_helperWasLastKnownActive` is meaningless
+static NSObject *_helperProbe = nil; /// Non-nil while we're asking the helper. Identifies the current probe, so we can ignore the answers of probes that were overtaken by an invalidation.
+static dispatch_source_t _helperExitSource = nil;
+
+static dispatch_queue_t helperStateQueue(void) {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, -1);
+        queue = dispatch_queue_create("com.nuebling.mac-mouse-fix.helper-state", attr);
+    });
+    return queue;
+}
+
+static dispatch_group_t helperProbeGroup(void) {
+    /// Every running probe is 'in' this group. Lets `helperIsActive_Cached` wait for the first probe.
+    static dispatch_group_t group;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        group = dispatch_group_create();
+    });
+    return group;
+}
+
+static BOOL helperIsActive_Cached(void) {
+    
+    /// Get cached state
+    ///     If it's unknown, start asking the helper and return the last state we knew. See `Helper state cache` above.
+    
+    __block BOOL isActive;
+    __block BOOL shouldWait = NO;
+    dispatch_sync(helperStateQueue(), ^{
+        if (_helperState == kMFHelperStateUnknown) {
+            startHelperProbe_Unsafe();
+            isActive = _helperWasLastKnownActive;
+            shouldWait = !_helperStateWasEverKnown;
+        } else {
+            isActive = _helperState == kMFHelperStateActive;
+        }
+    });
+    
+    /// Wait for the first probe
+    if (shouldWait) {
+        long timedOut = dispatch_group_wait(helperProbeGroup(), dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kMFFirstHelperProbeTimeout * NSEC_PER_SEC)));
+        if (timedOut) {
+            DDLogWarn(@"HelperServices - first helper probe didn't answer within %f s. Assuming the last known state.", kMFFirstHelperProbeTimeout);
+        }
+        dispatch_sync(helperStateQueue(), ^{
+            if (_helperState != kMFHelperStateUnknown) {
+                isActive = _helperState == kMFHelperStateActive;
+            }
+        });
+    }
+    
+    return isActive;
+}
+
++ (void)probeHelperStateInBackground {
+    dispatch_async(helperStateQueue(), ^{
+        if (_helperState == kMFHelperStateUnknown) {
+            startHelperProbe_Unsafe();
+        }
+    });
+}
+
++ (void)helperDidReportEnabled:(BOOL)enabled payload:(NSDictionary *_Nullable)payload {
+    
+    /// Called by MFMessagePort when the helper tells us that it was enabled or disabled.
+    
+    NSNumber *bundleVersion = payload[@"bundleVersion"];
+    NSNumber *pid = payload[@"pid"];
+    
+    dispatch_async(helperStateQueue(), ^{
+        if (enabled && bundleVersion != nil && bundleVersion.integerValue == Locator.bundleVersion) {
+            setHelperState_Unsafe(kMFHelperStateActive, pid != nil ? pid.intValue : -1);
+        } else if (enabled) {
+            setHelperState_Unsafe(kMFHelperStateUnknown, -1); /// Don't know about this helper -> ask it
+        } else {
+            setHelperState_Unsafe(kMFHelperStateInactive, -1);
+        }
+    });
+}
+
+static void invalidateHelperState(void) {
+    dispatch_async(helperStateQueue(), ^{
+        setHelperState_Unsafe(kMFHelperStateUnknown, -1);
+    });
+}
+
+static void startHelperProbe_Unsafe(void) {
+    
+    /// Only call on `helperStateQueue()`
+    
+    if (_helperProbe != nil) return;
+    
+    NSObject *probe = [[NSObject alloc] init];
+    _helperProbe = probe;
+    dispatch_group_enter(helperProbeGroup());
+    
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        
+        NSDictionary *info = helperInfo_Message();
+        
+        dispatch_async(helperStateQueue(), ^{
+            
+            if (_helperProbe == probe) { /// Otherwise the state was invalidated while we were asking
+                storeHelperProbeResult_Unsafe(info);
+            }
+            
+            /// Let waiters in `helperIsActive_Cached` continue
+            ///     After storing the result, so they see it when they `dispatch_sync` onto the `helperStateQueue()`
+            dispatch_group_leave(helperProbeGroup());
+        });
+    });
+}
+
+static void storeHelperProbeResult_Unsafe(NSDictionary *_Nullable info) {
+    
+    /// Only call on `helperStateQueue()`
+    
+    BOOL wasActive = _helperWasLastKnownActive;
+    if (info != nil) {
+        setHelperState_Unsafe(kMFHelperStateActive, [info[@"pid"] intValue]);
+    } else {
+        setHelperState_Unsafe(kMFHelperStateInactive, -1);
+    }
+    BOOL isActive = _helperWasLastKnownActive;
+    
+    /// Publish
+    ///     Callers of `helperIsActive` might have gotten the old state while we were asking.
+#if IS_MAIN_APP
+    if (isActive != wasActive) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (isActive) [EnabledState.shared reactToDidBecomeEnabled];
+            else          [EnabledState.shared reactToDidBecomeDisabled];
+        });
+    }
+#endif
+}
+
+static void setHelperState_Unsafe(MFHelperState state, pid_t pid) {
+    
+    /// Only call on `helperStateQueue()`
+    
+    DDLogDebug(@"HelperServices - helper state changed to %d (pid: %d)", state, pid);
+    
+    _helperState = state;
+    _helperProbe = nil;
+    if (state != kMFHelperStateUnknown) {
+        _helperWasLastKnownActive = state == kMFHelperStateActive;
+        _helperStateWasEverKnown = YES;
+    }
+    
+    /// Stop watching old process
+    if (_helperExitSource != nil) {
+        dispatch_source_cancel(_helperExitSource);
+        _helperExitSource = nil;
+    }
+    
+    /// Watch new process
+    if (state == kMFHelperStateActive && pid > 0) {
+        
+        dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_PROC, (uintptr_t)pid, DISPATCH_PROC_EXIT, helperStateQueue());
+        dispatch_source_set_event_handler(source, ^{
+            if (_helperExitSource == source) {
+                DDLogInfo(@"HelperServices - helper process %d exited", pid);
+                setHelperState_Unsafe(kMFHelperStateInactive, -1);
+            }
+        });
+        _helperExitSource = source;
+        dispatch_resume(source);
+        
+        /// Catch the process having exited before we started watching
+        if (kill(pid, 0) != 0 && errno == ESRCH) {
+            setHelperState_Unsafe(kMFHelperStateInactive, -1);
+        }
+    }
+}
+
+static BOOL pidIsHelper(pid_t pid) {
+    
+    /// Checks that `pid` belongs to a running process of our helper executable.
+    ///     `kill(pid, 0)` alone isn't enough. After the helper quits, its pid can be reused by an unrelated process, and the stale pid in the shared status block would then look alive.
+    
+    if (pid <= 0) return NO;
+    
+    char path[PROC_PIDPATHINFO_MAXSIZE];
+    int length = proc_pidpath(pid, path, sizeof(path));
+    if (length <= 0) return NO; /// Process doesn't exist (anymore)
+    
+    NSString *executablePath = [[NSString alloc] initWithBytes:path length:length encoding:NSUTF8StringEncoding];
+    return [executablePath isEqual:Locator.helperBundle.executablePath];
+}
+
+static NSDictionary *_Nullable helperInfo_Message(void) {
+    
+    /// Like `helperIsActive_Message`, but also gets the helper's pid, so we can watch the process
+    ///     Returns nil if the helper isn't running or its bundleVersion doesn't match ours.
+    
+    assert(runningMainApp());
+    
+    /// Try the shared status block first
+    ///     The helper publishes its pid and bundleVersion there when it starts (See MFSharedStatus.m). The block outlives the helper, so we check that the process is still around.
+    ///     That's a few memory reads and a syscall instead of a message round trip. We only fall back to the message port if the block doesn't tell us anything.
+    MFSharedStatus status;
+    if (MFSharedStatusRead(&status) && status.helperBundleVersion == (uint32_t)Locator.bundleVersion && pidIsHelper((pid_t)status.helperPid)) {
+        return @{ @"pid": @(status.helperPid), @"bundleVersion": @(status.helperBundleVersion) };
+    }
+    
+    NSDictionary *response = (NSDictionary *)[MFMessagePort sendMessage:@"getHelperInfo" withPayload:nil waitForReply:YES];
+    if (![response isKindOfClass:[NSDictionary class]]) return nil; /// Older helpers don't know `getHelperInfo`. Their bundleVersion wouldn't match anyways.
+    
+    NSNumber *bundleVersion = response[@"bundleVersion"];
+    if (bundleVersion == nil || bundleVersion.integerValue != Locator.bundleVersion) return nil;
+    
+    return response;
+}
+
 #pragma mark Check Helper Is Active
 
 + (BOOL)helperIsActive_Message {
@@ -379,16 +641,15 @@
 static BOOL helperIsActive_PList(void) {
     
     /// Get info from launchd
-    NSString *launchctlOutput = launchctl_list(kMFLaunchdHelperIdentifier);
+    NSDictionary *launchctlInfo = [LaunchctlParser parseOutput:launchctl_list(kMFLaunchdHelperIdentifier)];
     
     /// Analyze info
     
     /// Check if label exists. This should always be found if the helper is registered with launchd. Or equavalently, if the output isn't "Could not find service "mouse.fix.helper" in domain for port"
-    NSString *labelSearchString = stringf(@"\"Label\" = \"%@\";", kMFLaunchdHelperIdentifier);
-    BOOL labelFound = [launchctlOutput rangeOfString: labelSearchString].location != NSNotFound;
+    BOOL labelFound = [launchctlInfo[@"Label"] isEqual:kMFLaunchdHelperIdentifier];
     
     /// Check exit status. Not sure if useful
-    BOOL exitStatusIsZero = [launchctlOutput rangeOfString: @"\"LastExitStatus\" = 0;"].location != NSNotFound;
+    BOOL exitStatusIsZero = [launchctlInfo[@"LastExitStatus"] isEqual:@"0"];
     
     if ([HelperServices strangeHelperIsRegisteredWithLaunchdIdentifier:kMFLaunchdHelperIdentifier]) {
         DDLogInfo(@"Found helper running somewhere else.");
@@ -598,10 +859,10 @@ NSString *launchctl_print(NSString *identifier) {
         
         assert([identifier isEqual:kMFLaunchdHelperIdentifier]);
         
-        NSString *launchctlOutput = launchctl_list(identifier);
-        NSString *executablePath = [launchctlOutput substringWithRegex:@"(?<=\"Program\" = \").*(?=\";)"];
+        NSDictionary *launchctlInfo = [LaunchctlParser parseOutput:launchctl_list(identifier)];
+        NSString *executablePath = launchctlInfo[@"Program"];
         
-        return executablePath;
+        return executablePath ?: @"";
     }
 }
 
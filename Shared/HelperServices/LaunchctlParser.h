@@ -0,0 +1,20 @@
+//
+// --------------------------------------------------------------------------
+// LaunchctlParser.h
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface LaunchctlParser : NSObject
+
++ (NSDictionary *_Nullable)parseOutput:(NSString *)output;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,123 @@
+//
+// --------------------------------------------------------------------------
+// LaunchctlParser.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Parses the output of `launchctl list <label>` into an NSDictionary.
+///
+/// Why:
+///     HelperServices used to search the raw output with `rangeOfString:` and a regex for each value it needed. That's fragile (e.g. the `"Label" = ...` search string has to match the exact whitespace) and scans the whole output once per value.
+///
+/// How:
+///     It's a small line-based state machine with a stack of open containers. The output looks like this:
+///     ```
+///     {
+///         "Label" = "mouse.fix.helper";
+///         "PID" = 709;
+///         "Program" = "/Applications/...";
+///         "ProgramArguments" = (
+///             "/Applications/...";
+///         );
+///     };
+///     ```
+///     - `{` / `"key" = {` open a dict, `"key" = (` opens an array. `}` / `)` (with or without `;`) close them.
+///     - `"key" = value;` lines set a value in a dict. Quotes and the trailing `;` are removed. Values are always strings.
+///     - `value;` lines add an item to an array.
+///     - Anything outside the outermost container is ignored. If there is no container (e.g. `Could not find service ...`), we return nil.
+
+#import "LaunchctlParser.h"
+
+#pragma mark - Helper
+
+static NSString *stripSemicolon(NSString *s) {
+    if ([s hasSuffix:@";"]) {
+        s = [s substringToIndex:s.length - 1];
+        s = [s stringByTrimmingCharactersInSet:NSCharacterSet.whitespaceCharacterSet];
+    }
+    return s;
+}
+
+static NSString *unquote(NSString *s) {
+    if (s.length >= 2 && [s hasPrefix:@"\""] && [s hasSuffix:@"\""]) {
+        return [s substringWithRange:NSMakeRange(1, s.length - 2)];
+    }
+    return s;
+}
+
+#pragma mark - Parser
+
+@implementation LaunchctlParser
+
++ (NSDictionary *)parseOutput:(NSString *)output {
+    
+    /// Stack of open containers. Each one is an NSMutableDictionary or NSMutableArray. `keys` holds the key under which each container will be stored in its parent.
+    NSMutableArray *stack = [NSMutableArray array];
+    NSMutableArray<NSString *> *keys = [NSMutableArray array];
+    
+    for (NSString *rawLine in [output componentsSeparatedByCharactersInSet:NSCharacterSet.newlineCharacterSet]) {
+        
+        NSString *line = stripSemicolon([rawLine stringByTrimmingCharactersInSet:NSCharacterSet.whitespaceCharacterSet]);
+        if (line.length == 0) continue;
+        
+        /// Close
+        if ([line isEqual:@"}"] || [line isEqual:@")"]) {
+            
+            if (stack.count == 0) continue;
+            
+            id container = stack.lastObject;
+            NSString *key = keys.lastObject;
+            [stack removeLastObject];
+            [keys removeLastObject];
+            
+            if (stack.count == 0) {
+                /// Outermost container -> done
+                return [container isKindOfClass:[NSDictionary class]] ? [container copy] : @{};
+            }
+            
+            id parent = stack.lastObject;
+            if ([parent isKindOfClass:[NSMutableDictionary class]]) {
+                parent[key] = [container copy];
+            } else {
+                [parent addObject:[container copy]];
+            }
+            continue;
+        }
+        
+        /// Split at ` = `
+        NSString *key = @"";
+        NSString *value = line;
+        NSRange separator = [line rangeOfString:@" = "];
+        if (separator.location != NSNotFound) {
+            key = unquote([line substringToIndex:separator.location]);
+            value = [line substringFromIndex:NSMaxRange(separator)];
+        }
+        
+        /// Open
+        if ([value isEqual:@"{"] || [value isEqual:@"("]) {
+            [stack addObject:[value isEqual:@"{"] ? [NSMutableDictionary dictionary] : [NSMutableArray array]];
+            [keys addObject:key];
+            continue;
+        }
+        
+        /// Value
+        id parent = stack.lastObject;
+        if ([parent isKindOfClass:[NSMutableDictionary class]] && separator.location != NSNotFound) {
+            parent[key] = unquote(value);
+        } else if ([parent isKindOfClass:[NSMutableArray class]]) {
+            [parent addObject:unquote(value)];
+        }
+    }
+    
+    /// Handle truncated output
+    ///     Return what we got so far.
+    if (stack.count > 0 && [stack.firstObject isKindOfClass:[NSDictionary class]]) {
+        return [stack.firstObject copy];
+    }
+    return nil;
+}
+
+@end
@@ -9,6 +9,7 @@
 
 /// This is a thin wrapper / collection of convenience functions around TrialCounter.swift and Gumroad.swift.
 /// One of the more interesting things it does is It adds offline caching to Gumroad.swift and automatically gathers parameters for it.
+/// It also caches Gumroad's answer in memory (see `storedKeyVerification`), so repeated checks from the UI and the helper don't each do a keychain read and an HTTP request. All network requests go through `License.transport`.
 /// It was meant to be an Interface for Gumroad.swift, so that Gumroad.swift wouldn't be used except by License.swift, but for the LicenseSheet it made sense to use Gumroad.swift directly, because we don't want any caching when activating the license.
 /// At the time of writing it is an interface for TrialCounter.swift, which is not used by anything else except by the inputModules which report being used through the `handleUse()` function
 
@@ -281,63 +282,60 @@ extension MFLicenseAndTrialState: Equatable {
             }
             
             /// Cache stuff
-            self.isLicensedCache = isLicensed
-            self.licenseReasonCache = licenseReason
+            ///     Only write if something changed. Every write commits the config, and we get here a lot more often now that the Gumroad response is cached in memory.
+            if self.isLicensedCache != isLicensed {
+                self.isLicensedCache = isLicensed
+            }
+            if self.licenseReasonCache != licenseReason {
+                self.licenseReasonCache = licenseReason
+            }
 
             /// Call completionHandler
             completionHandler(isLicensed, freshness, licenseReason, error)
         }
         
-        /// Get key
-        ///     From secure storage if `keyArg` == nil
-        
-        var key: String
+        /// Define evaluation
+        ///     This decides whether the license is valid based on what Gumroad told us about the key
+        ///     `freshnessIfOnline` is the freshness we report if Gumroad could be reached. It's `kMFValueFreshnessCached` if Gumroad's answer came from `storedKeyVerification` and is stale.
         
-        if let keyArg = keyArg {
-            key = keyArg
-        } else {
-            guard let keyStorage = SecureStorage.get("License.key") as! String? else {
-
+        let evaluate = { (verification: KeyVerification, freshnessIfOnline: MFValueFreshness) -> () in
+            
+            if !verification.keyFound {
+                
                 /// No key provided in function arg and no key found in secure storage
                 
                 /// Return unlicensed
                 let error = NSError(domain: MFLicenseErrorDomain, code: Int(kMFLicenseErrorCodeKeyNotFound))
-                wrapUp(false, kMFValueFreshnessFresh, error, licenseConfig, completionHandler)
+                wrapUp(false, freshnessIfOnline, error, licenseConfig, completionHandler)
                 return
             }
             
-            key = keyStorage
-        }
-        
-        /// Ask gumroad to verify
-        Gumroad.getLicenseInfo(key, incrementUsageCount: incrementUsageCount) { isValidKey, nOfActivations, serverResponse, error, urlResponse in
-            
-            if isValidKey { /// Gumroad says the license is valid
+            if verification.isValidKey { /// Gumroad says the license is valid
                 
                 /// Validate activation count
                 
                 var validActivationCount = false
-                if let a = nOfActivations, a <= licenseConfig.maxActivations {
+                if let a = verification.nOfActivations, a <= licenseConfig.maxActivations {
                     validActivationCount = true
                 }
                 
                 if !validActivationCount {
 
-                    let error = NSError(domain: MFLicenseErrorDomain, code: Int(kMFLicenseErrorCodeInvalidNumberOfActivations), userInfo: ["nOfActivations": nOfActivations ?? -1, "maxActivations": licenseConfig.maxActivations])
+                    let error = NSError(domain: MFLicenseErrorDomain, code: Int(kMFLicenseErrorCodeInvalidNumberOfActivations), userInfo: ["nOfActivations": verification.nOfActivations ?? -1, "maxActivations": licenseConfig.maxActivations])
                     
-                    wrapUp(false, kMFValueFreshnessFresh, error, licenseConfig, completionHandler)
+                    wrapUp(false, freshnessIfOnline, error, licenseConfig, completionHandler)
                     return
                 }
                     
                     
                 /// Is licensed!
                 
-                wrapUp(true, kMFValueFreshnessFresh, nil, licenseConfig, completionHandler)
+                wrapUp(true, freshnessIfOnline, nil, licenseConfig, completionHandler)
                 return
                 
             } else { /// Gumroad says key is not valid
                 
-                if let error = error,
+                if let error = verification.error,
                    error.domain == NSURLErrorDomain {
                     
                     /// Failed due to internet issues -> try cache
@@ -361,11 +359,67 @@ extension MFLicenseAndTrialState: Equatable {
                 } else {
                     
                     /// Failed despite good internet connection -> Is actually unlicensed
-                    wrapUp(false, kMFValueFreshnessFresh, error, licenseConfig, completionHandler) /// Pass through the error from Gumroad.swift
+                    wrapUp(false, freshnessIfOnline, verification.error, licenseConfig, completionHandler) /// Pass through the error from Gumroad.swift
                     return
                 }
             }
         }
+        
+        /// Ask gumroad to verify
+        
+        if let keyArg = keyArg {
+            
+            /// Key provided by the caller (LicenseSheet) -> Always ask Gumroad directly
+            
+            Gumroad.getLicenseInfo(keyArg, incrementUsageCount: incrementUsageCount) { isValidKey, nOfActivations, serverResponse, error, urlResponse in
+                evaluate(KeyVerification(keyFound: true, isValidKey: isValidKey, nOfActivations: nOfActivations, error: error), kMFValueFreshnessFresh)
+            }
+            
+        } else {
+            
+            /// Use the key from secure storage -> Go through the cache
+            
+            assert(!incrementUsageCount)
+            
+            storedKeyVerification.get { verification, source in
+                evaluate(verification, source == .stale ? kMFValueFreshnessCached : kMFValueFreshnessFresh)
+            }
+        }
+    }
+    
+    // MARK: Verification cache
+    
+    /// Caches Gumroad's answer for the key in secure storage.
+    ///     Notes:
+    ///     - We cache the raw answer instead of the final result, because the final result also depends on the licenseConfig that the caller passes in (maxActivations, freeCountries).
+    ///     - The keychain read happens inside the fetch, so it happens on a background queue and at most once per fetch.
+    ///     - Call `invalidateCache()` whenever the key in secure storage changes. We can't notice that ourselves without reading the keychain.
+    ///     - `invalidateCache()` invalidates the cache in the mainApp and the helper through the `licenseChangedNotification` Darwin notification. It writes the new key to the keychain first, so the other process reads the new key when it refetches.
+    ///     - Network failures count as failures for the cache's backoff. A definitive "invalid key" from Gumroad does not.
+    
+    static var transport: LicenseTransport = URLSessionLicenseTransport()
+    
+    static let licenseChangedNotification = "com.nuebling.mac-mouse-fix.license-changed"
+    
+    @objc static func invalidateCache() {
+        SecureStorage.flushPendingWrite()
+        storedKeyVerification.invalidate()
+        notify_post(licenseChangedNotification)
+    }
+    
+    private static let storedKeyVerification = RevalidatingCache<KeyVerification>(label: "license-verification", maxAge: 10*60, maxStaleAge: 60*60, minBackoff: 10, maxBackoff: 30*60, invalidationNotification: licenseChangedNotification) { onComplete in
+        
+        /// Get key from secure storage
+        guard let key = SecureStorage.get("License.key") as! String? else {
+            onComplete(KeyVerification(keyFound: false, isValidKey: false, nOfActivations: nil, error: nil), true)
+            return
+        }
+        
+        /// Ask Gumroad
+        Gumroad.getLicenseInfo(key, incrementUsageCount: false) { isValidKey, nOfActivations, serverResponse, error, urlResponse in
+            let isNetworkFailure = !isValidKey && error?.domain == NSURLErrorDomain
+            onComplete(KeyVerification(keyFound: true, isValidKey: isValidKey, nOfActivations: nOfActivations, error: error), !isNetworkFailure)
+        }
     }
     
     // MARK: Cache interface
@@ -399,6 +453,13 @@ extension MFLicenseAndTrialState: Equatable {
 
 // MARK: Gumroad api wrapper
 
+fileprivate struct KeyVerification {
+    let keyFound: Bool
+    let isValidKey: Bool
+    let nOfActivations: Int?
+    let error: NSError?
+}
+
 fileprivate class Gumroad: NSObject {
         
     //
@@ -494,7 +555,7 @@ fileprivate class Gumroad: NSObject {
         
         /// Send request
 
-        let task = URLSession.shared.dataTask(with: request) { data, urlResponse, error in
+        License.transport.send(request) { data, urlResponse, error in
             
             /// Handle response
             
@@ -538,8 +599,6 @@ fileprivate class Gumroad: NSObject {
                 completionHandler(nil, error, urlResponse) /// This is the `error` from the catch statement not the closure argument
             }
         }
-        
-        task.resume()
     }
     
     private static func gumroadAPIRequest(method: String, args: [String: Any]) -> URLRequest {
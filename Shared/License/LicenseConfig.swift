@@ -26,6 +26,20 @@ import CocoaLumberjackSwift
     
     @objc static func get(onComplete: @escaping (LicenseConfig) -> ()) {
         
+        /// Notes:
+        /// - This goes through `cache`, so calling it a lot is cheap. Concurrent calls share one download, and we don't download more than once every `maxAge` seconds. See RevalidatingCache.swift for more.
+        /// - If the cached config is stale, we return a copy with `kMFValueFreshnessCached`, so the callers can still tell that it's not fresh from the internet.
+        
+        cache.get { instance, source in
+            if source == .stale {
+                onComplete(instance.copy(freshness: kMFValueFreshnessCached))
+            } else {
+                onComplete(instance)
+            }
+        }
+    }
+    
+    private static let cache = RevalidatingCache<LicenseConfig>(label: "license-config", maxAge: 10*60, maxStaleAge: 24*60*60, minBackoff: 10, maxBackoff: 30*60) { onComplete in
         
         /// Create garbage instance
         
@@ -33,18 +47,18 @@ import CocoaLumberjackSwift
         
         /// Download licenseConfig.json
         
-        let request = URLRequest(url: URL(string: licenseConfigAddress)!, cachePolicy: .reloadIgnoringLocalAndRemoteCacheData, timeoutInterval: 10.0)
+        let request = URLRequest(url: URL(string: LicenseConfig.licenseConfigAddress)!, cachePolicy: .reloadIgnoringLocalAndRemoteCacheData, timeoutInterval: 10.0)
         
-        let task = URLSession.shared.downloadTask(with: request) { url, urlResponse, error in
+        License.transport.send(request) { data, urlResponse, error in
             
             /// Try to extract instance from downloaded data
-            if let url = url {
+            if let data = data {
                 do {
-                    let dict = try dictFromJSON(url)
+                    let dict = try LicenseConfig.dictFromJSON(data)
                     try instance.fillFromDict(dict)
                     LicenseConfig.configCache = dict
                     instance.freshness = kMFValueFreshnessFresh
-                    onComplete(instance)
+                    onComplete(instance, true)
                     return
                 } catch { }
             }
@@ -53,10 +67,8 @@ import CocoaLumberjackSwift
             DDLogInfo("Failed to get LicenseConfig from internet, using cache instead...")
             
             /// Downloading failed, use cache instead
-            onComplete(getCached())
+            onComplete(LicenseConfig.getCached(), false)
         }
-        
-        task.resume()
     }
     
     /// Cached init
@@ -139,6 +151,25 @@ import CocoaLumberjackSwift
         }
     }
     
+    /// Copying
+    
+    private func copy(freshness: MFValueFreshness) -> LicenseConfig {
+        
+        let new = LicenseConfig()
+        new.maxActivations = maxActivations
+        new.trialDays = trialDays
+        new.price = price
+        new.payLink = payLink
+        new.quickPayLink = quickPayLink
+        new.altPayLink = altPayLink
+        new.altQuickPayLink = altQuickPayLink
+        new.altPayLinkCountries = altPayLinkCountries
+        new.freeCountries = freeCountries
+        new.isFilled = isFilled
+        new.freshness = freshness
+        return new
+    }
+    
     /// Equatability
     
     override func isEqual(to object: Any?) -> Bool {
@@ -193,12 +224,19 @@ import CocoaLumberjackSwift
         
         /// Extract dict from json url
         
-        var dict: [String: Any]? = nil
         let data = try Data(contentsOf: jsonURL)
+        return try dictFromJSON(data)
+    }
+    
+    private static func dictFromJSON(_ data: Data) throws -> [String: Any] {
+        
+        /// Extract dict from json data
+        
+        var dict: [String: Any]? = nil
         dict = try JSONSerialization.jsonObject(with: data) as? [String: Any]
         
         if dict == nil {
-            throw NSError(domain: "Lazydomain", code: 0, userInfo: ["Couldn't extract dict from json at url": jsonURL])
+            throw NSError(domain: "Lazydomain", code: 0, userInfo: ["Couldn't extract dict from json data": data])
         }
         
         /// Return
@@ -0,0 +1,25 @@
+//
+// --------------------------------------------------------------------------
+// LicenseTransport.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// All the network requests of the licensing code (Gumroad API and the LicenseConfig download) go through `License.transport`.
+///     That way, you can swap in something that serves canned responses (or talks to a local server) to test the caching, the request coalescing, and the backoff in `RevalidatingCache`, without hitting Gumroad or GitHub.
+
+import Foundation
+
+protocol LicenseTransport: AnyObject {
+    func send(_ request: URLRequest, completionHandler: @escaping (_ data: Data?, _ urlResponse: URLResponse?, _ error: Error?) -> ())
+}
+
+class URLSessionLicenseTransport: LicenseTransport {
+    
+    func send(_ request: URLRequest, completionHandler: @escaping (Data?, URLResponse?, Error?) -> ()) {
+        let task = URLSession.shared.dataTask(with: request, completionHandler: completionHandler)
+        task.resume()
+    }
+}
@@ -0,0 +1,196 @@
+//
+// --------------------------------------------------------------------------
+// RevalidatingCache.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// In-memory cache for a value that we get through some slow, asynchronous and possibly failing `fetch`. Used for the LicenseConfig and for verifying the stored license key with Gumroad.
+///
+/// __Why__
+/// - The about tab, the license sheet, the helper and the TrialCounter all call `LicenseConfig.get()` and `License.checkLicenseAndTrial()`. Before, each call did its own keychain read and its own HTTP requests, even if the same request was already running or had just finished.
+///
+/// __How__
+/// - If the value is younger than `maxAge`, we return it right away (`.fresh`).
+/// - If it's younger than `maxStaleAge`, we still return it right away (`.stale`), but we also start a fetch in the background, so the next caller gets a fresh value. (Stale-while-revalidate)
+/// - Otherwise the caller waits for a fetch. Callers that come in while a fetch is running don't start a new one, they just wait for the running one. (`.fetched`)
+/// - If a fetch fails, we don't fetch again until the backoff has passed. The backoff starts at `minBackoff` and doubles with every failure in a row, up to `maxBackoff`. During the backoff, callers get the result of the failed fetch (`.backoff`). (The fetch still needs to produce a result when it fails - for us that's whatever the offline fallback is.)
+///
+/// __Notes__
+/// - Completion handlers are called on a global queue, never on the caller's thread. `fetch` is also called on a global queue, so it can do blocking stuff like keychain reads.
+/// - `invalidate()` drops the value and the backoff. Fetches that are already running still complete their waiting callers, but their result isn't stored.
+/// - If you pass an `invalidationNotification`, posting that Darwin notification (`notify_post()`) invalidates the cache in every process that has one. That's how the helper finds out that the mainApp changed the license key.
+
+import Foundation
+import CocoaLumberjackSwift
+
+final class RevalidatingCache<Value> {
+    
+    /// Types
+    
+    enum Source {
+        case fresh
+        case stale
+        case fetched
+        case backoff
+    }
+    
+    typealias Fetch = (_ onComplete: @escaping (_ value: Value, _ succeeded: Bool) -> ()) -> ()
+    typealias Completion = (_ value: Value, _ source: Source) -> ()
+    
+    private final class Batch {
+        var waiters: [Completion] = []
+    }
+    
+    /// Params
+    
+    private let maxAge: TimeInterval
+    private let maxStaleAge: TimeInterval
+    private let minBackoff: TimeInterval
+    private let maxBackoff: TimeInterval
+    private let fetch: Fetch
+    
+    /// State
+    ///     Only access on `queue`
+    
+    private let queue: DispatchQueue
+    private var value: Value? = nil
+    private var fetchedAt: CFTimeInterval = 0
+    private var lastFailure: Value? = nil
+    private var failureCount: Int = 0
+    private var nextAttempt: CFTimeInterval = 0
+    private var runningBatch: Batch? = nil
+    private var generation: Int = 0
+    private var notifyToken: Int32 = NOTIFY_TOKEN_INVALID
+    
+    /// Init
+    
+    init(label: String, maxAge: TimeInterval, maxStaleAge: TimeInterval, minBackoff: TimeInterval, maxBackoff: TimeInterval, invalidationNotification: String? = nil, fetch: @escaping Fetch) {
+        
+        assert(maxAge <= maxStaleAge)
+        assert(minBackoff <= maxBackoff)
+        
+        self.queue = DispatchQueue(label: "com.nuebling.mac-mouse-fix.\(label)", qos: .utility, attributes: [], autoreleaseFrequency: .inherit, target: nil)
+        self.maxAge = maxAge
+        self.maxStaleAge = maxStaleAge
+        self.minBackoff = minBackoff
+        self.maxBackoff = maxBackoff
+        self.fetch = fetch
+        
+        if let name = invalidationNotification {
+            let status = notify_register_dispatch(name, &notifyToken, queue) { [weak self] _ in
+                self?.invalidate()
+            }
+            if status != NOTIFY_STATUS_OK {
+                DDLogWarn("RevalidatingCache \(label) - Failed to register for \(name). Status: \(status). Changes from other processes won't invalidate the cache.")
+            }
+        }
+    }
+    
+    deinit {
+        if notifyToken != NOTIFY_TOKEN_INVALID {
+            notify_cancel(notifyToken)
+        }
+    }
+    
+    /// Interface
+    
+    func get(_ onComplete: @escaping Completion) {
+        
+        queue.async {
+            
+            let now = CACurrentMediaTime()
+            
+            /// Serve from cache
+            if let value = self.value {
+                let age = now - self.fetchedAt
+                if age < self.maxAge {
+                    self.deliver(value, .fresh, to: [onComplete])
+                    return
+                }
+                if age < self.maxStaleAge {
+                    self.deliver(value, .stale, to: [onComplete])
+                    self.startFetchIfPossible(now: now)
+                    return
+                }
+            }
+            
+            /// Serve last failure during backoff
+            if now < self.nextAttempt, let lastFailure = self.lastFailure {
+                self.deliver(lastFailure, .backoff, to: [onComplete])
+                return
+            }
+            
+            /// Wait for fetch
+            self.startFetchIfPossible(now: now)
+            self.runningBatch!.waiters.append(onComplete)
+        }
+    }
+    
+    func invalidate() {
+        queue.async {
+            self.generation += 1
+            self.value = nil
+            self.fetchedAt = 0
+            self.lastFailure = nil
+            self.failureCount = 0
+            self.nextAttempt = 0
+            self.runningBatch = nil /// The running fetch keeps its batch alive and completes it
+        }
+    }
+    
+    /// Helper
+    
+    private func startFetchIfPossible(now: CFTimeInterval) {
+        
+        /// Only call on `queue`
+        
+        if runningBatch != nil { return }
+        if now < nextAttempt && lastFailure != nil { return }
+        
+        let batch = Batch()
+        let generation = self.generation
+        runningBatch = batch
+        
+        DispatchQueue.global(qos: .utility).async {
+            self.fetch { value, succeeded in
+                self.queue.async {
+                    
+                    /// Store
+                    if generation == self.generation {
+                        
+                        let now = CACurrentMediaTime()
+                        if succeeded {
+                            self.value = value
+                            self.fetchedAt = now
+                            self.lastFailure = nil
+                            self.failureCount = 0
+                            self.nextAttempt = 0
+                        } else {
+                            self.failureCount += 1
+                            let backoff = min(self.minBackoff * pow(2.0, Double(self.failureCount - 1)), self.maxBackoff)
+                            self.lastFailure = value
+                            self.nextAttempt = now + backoff
+                            DDLogInfo("RevalidatingCache \(self.queue.label) - fetch failed \(self.failureCount) times in a row. Backing off for \(backoff)s")
+                        }
+                        self.runningBatch = nil
+                    }
+                    
+                    /// Complete waiters
+                    self.deliver(value, .fetched, to: batch.waiters)
+                }
+            }
+        }
+    }
+    
+    private func deliver(_ value: Value, _ source: Source, to completions: [Completion]) {
+        if completions.isEmpty { return }
+        DispatchQueue.global(qos: .userInitiated).async {
+            for c in completions {
+                c(value, source)
+            }
+        }
+    }
+}
@@ -25,18 +25,66 @@
 
 /// - `[x]` Doesn't increment daysOfUse when using Trackpad
 
+/// Performance notes
+/// - `handleUse()` is called for every scroll tick, every button trigger and every drag. So it should cost almost nothing once the use for today has been recorded.
+/// - Before, it logged a debug message, read the `@Atomic` `hasBeenUsedToday` flag (which takes a lock), and - until the background block had set the flag - could dispatch several blocks which all incremented `daysOfUse`. (That race probably never counted a day twice in practice, because the first block usually ran before the next event came in, but nothing guaranteed it.)
+/// - Now, the hot path is one relaxed atomic load of `needsToRecordUse`. Only the first use of the day goes further. It clears the flag and schedules a flush on `persistenceQueue`.
+/// - The flush is delayed by `flushDelay`, so all uses from the burst that started the day are coalesced into a single write of `lastUseDate` + `daysOfUse`. (Each keychain access is an IPC call to securityd, so we don't want to do them more than necessary.)
+/// - The flush is idempotent per day: It compares the stored `lastUseDate` with today before incrementing. So even if 2 threads pass the load before either of them clears the flag, the day is counted once.
+/// - Where the counters are stored is abstracted behind `TrialCounterStorage`. The default is `SecureStorage` (the keychain). TrialCounterTests runs the counting logic (`recordUse(at:in:)`) against an in-memory implementation, without touching the keychain.
+
 import Cocoa
 import CocoaLumberjackSwift
 
+/// Storage
+
+protocol TrialCounterStorage: AnyObject {
+    var daysOfUse: Int { get set }
+    var lastUseDate: Date? { get set }
+}
+
+class SecureStorageTrialCounterStorage: TrialCounterStorage {
+    
+    /// Notes:
+    /// - Storing the daysOfUse in SecureStorage so it doesn't get reset on uninstall by apps like AppCleaner by Freemacsoft.
+    
+    var daysOfUse: Int {
+        get {
+            SecureStorage.get("License.trial.daysOfUse") as? Int ?? 0
+        }
+        set {
+            SecureStorage.set("License.trial.daysOfUse", value: newValue)
+        }
+    }
+    var lastUseDate: Date? {
+        get {
+            SecureStorage.get("License.trial.lastUseDate") as? Date
+//            config("License.trial.lastUseDate") as? Date
+        }
+        set {
+            SecureStorage.set("License.trial.lastUseDate", value: newValue! as NSObject)
+//            setConfig("License.trial.lastUseDate", newValue! as NSObject)
+//            commitConfig()
+        }
+    }
+}
+
 @objc class TrialCounter: NSObject {
     
     /// Singleton
     @objc static let shared = TrialCounter()
     
+    /// Storage backend
+    static var storage: TrialCounterStorage = SecureStorageTrialCounterStorage()
+    
     /// Vars
     private var daily: Timer
-    @Atomic private var hasBeenUsedToday: Bool
-    private var trialIsActive: Bool
+    private let needsToRecordUse: UnsafeMutablePointer<Int32> /// 1 if the trial is active and we haven't recorded a use today. Only access through the `MFAtomic...()` functions. Never freed, since this is a singleton.
+    private var flushIsScheduled = false /// Only access on `persistenceQueue`
+    
+    /// Persistence
+    private let persistenceQueue = DispatchQueue(label: "com.nuebling.mac-mouse-fix.trial-counter", qos: .utility, attributes: [], autoreleaseFrequency: .inherit, target: nil)
+    private static let flushDelay: DispatchTimeInterval = .milliseconds(500)
     
     /// Init
     
@@ -48,8 +96,8 @@ import CocoaLumberjackSwift
         
         /// Garbage init
         daily = Timer()
-        hasBeenUsedToday = false
-        trialIsActive = false
+        needsToRecordUse = UnsafeMutablePointer<Int32>.allocate(capacity: 1)
+        needsToRecordUse.initialize(to: 0)
         
         /// Init super
         super.init()
@@ -83,20 +131,10 @@ import CocoaLumberjackSwift
                     
                     /// Trial period is active!
                     
-                    /// Set trialActive flag
-                    self.trialIsActive = true
-                    
-                    /// Init hasBeeUsedToday
-                    self.hasBeenUsedToday = false
-                    if let lastUseDate = TrialCounter.lastUseDate as? NSDate {
-                        let now = Date.init(timeIntervalSinceNow: 0)
-                        let a = Calendar.current.dateComponents([.day, .month, .year], from: lastUseDate as Date)
-                        let b = Calendar.current.dateComponents([.day, .month, .year], from: now)
-                        let isSameDay = a.day == b.day && a.month == b.month && a.year == b.year
-                        if isSameDay {
-                            self.hasBeenUsedToday = true
-                        }
-                    }
+                    /// Init needsToRecordUse
+                    ///     If the trial isn't active, this stays 0, so `handleUse()` returns right away.
+                    let hasBeenUsedToday = TrialCounter.isToday(TrialCounter.lastUseDate)
+                    MFAtomicStoreRelaxed(self.needsToRecordUse, hasBeenUsedToday ? 0 : 1)
                     
                     /// Init daily timer
                     ///     Notes:
@@ -108,7 +146,7 @@ import CocoaLumberjackSwift
                     let nextDayBreak = Calendar.current.startOfDay(for: nextDay)
                     self.daily = Timer(fire: nextDayBreak, interval: TimeInterval(secondsPerDay), repeats: true) { timer in
                         DDLogInfo("Daily trial timer fired")
-                        self.hasBeenUsedToday = false
+                        MFAtomicStoreRelaxed(self.needsToRecordUse, 1)
                     }
                     
                     /// Schedule daily timer
@@ -121,61 +159,83 @@ import CocoaLumberjackSwift
     
     /// Vars
     /// Notes:
-    /// - Storing the daysOfUse in SecureStorage so it doesn't get reset on uninstall by apps like AppCleaner by Freemacsoft.
+    /// - These go straight to `storage`. They are not cached, so the mainApp always sees what the helper last flushed.
     /// - At the time of writing, this is the ony part of TrialCounter.swift that is meant to be used by the mainApp.
     /// - At the time of writing, this is only accessed by License.swift. We will use this assumption when implementing the test flags like `FORCE_EXPIRED`. Accessing this from elsewhere might break the testing flags.
     
     @objc static var daysOfUse: Int {
-        get {
-            SecureStorage.get("License.trial.daysOfUse") as? Int ?? 0
-        }
-        set {
-            SecureStorage.set("License.trial.daysOfUse", value: newValue)
-        }
+        get { storage.daysOfUse }
+        set { storage.daysOfUse = newValue }
     }
     @objc static var lastUseDate: Date? {
-        get {
-            SecureStorage.get("License.trial.lastUseDate") as? Date
-//            config("License.trial.lastUseDate") as? Date
-        }
-        set {
-            SecureStorage.set("License.trial.lastUseDate", value: newValue! as NSObject)
-//            setConfig("License.trial.lastUseDate", newValue! as NSObject)
-//            commitConfig()
-        }
+        get { storage.lastUseDate }
+        set { storage.lastUseDate = newValue }
     }
     
     /// Interface for Helper
     @objc func handleUse() {
         
-        /// Debug
-        DDLogDebug("handling use in trial")
+        /// Hot path
+        ///     Note: We check runningHelper() on the slow path only. It's an assert so it doesn't matter for release builds anyways, but there's no need to slow down debug builds on every event.
+        if MFAtomicLoadRelaxed(needsToRecordUse) == 0 { return }
+        MFAtomicStoreRelaxed(needsToRecordUse, 0)
+        
+        /// Slow path - first use of the day
         
         /// Guard not running helper
         assert(runningHelper())
         
-        /// Only react if trial is active
-        if !trialIsActive { return }
+        persistenceQueue.async {
+            if self.flushIsScheduled { return }
+            self.flushIsScheduled = true
+            self.persistenceQueue.asyncAfter(deadline: .now() + TrialCounter.flushDelay) {
+                self.flushIsScheduled = false
+                self.flushUse()
+            }
+        }
+    }
+    
+    private func flushUse() {
         
-        /// Only react to use once a day
-        if hasBeenUsedToday { return }
+        /// Record today's use in `storage`, then let License react.
+        ///     Only call this on `persistenceQueue`.
         
-        DispatchQueue.global(qos: .background).async {
-            
-            /// Dispatching to another queue here because there was an obscure concurrency crash when trying to debug something. This is not necessary for normal operation but it shouldn't hurt.
-            
-            /// Update state
-            ///     Should we check whether the date has actually changed?
-            self.hasBeenUsedToday = true
-            TrialCounter.lastUseDate = Date(timeIntervalSinceNow: 0.0)
-            TrialCounter.daysOfUse += 1
+        /// Update state
+        if !TrialCounter.recordUse(at: Date(timeIntervalSinceNow: 0.0), in: TrialCounter.storage) {
+            DDLogDebug("TrialCounter - use for today already recorded")
+            return
+        }
+        DDLogDebug("TrialCounter - recorded use. daysOfUse: \(TrialCounter.daysOfUse)")
+        
+        /// Get updated licenseConfig
+        LicenseConfig.get { licenseConfig in
             
-            /// Get updated licenseConfig
-            LicenseConfig.get { licenseConfig in
-                
-                /// Display UI & lock down helper if necessary
-                License.checkAndReact(licenseConfig: licenseConfig, triggeredByUser: false)
-            }
+            /// Display UI & lock down helper if necessary
+            License.checkAndReact(licenseConfig: licenseConfig, triggeredByUser: false)
         }
     }
+    
+    /// Helper
+    
+    static func recordUse(at now: Date, in storage: TrialCounterStorage) -> Bool {
+        
+        /// Counts `now`'s day as a day of use, unless it's already been counted. Returns whether it counted.
+        ///     Split out of `flushUse()` so the tests can run it against an in-memory storage.
+        
+        /// Don't count the same day twice
+        if isToday(storage.lastUseDate, now: now) { return false }
+        
+        /// Update state
+        let daysOfUse = storage.daysOfUse + 1
+        storage.lastUseDate = now
+        storage.daysOfUse = daysOfUse
+        return true
+    }
+    
+    private static func isToday(_ date: Date?, now: Date = Date(timeIntervalSinceNow: 0)) -> Bool {
+        guard let date = date else { return false }
+        let a = Calendar.current.dateComponents([.day, .month, .year], from: date)
+        let b = Calendar.current.dateComponents([.day, .month, .year], from: now)
+        return a.day == b.day && a.month == b.month && a.year == b.year
+    }
 }
@@ -22,6 +22,7 @@ NS_ASSUME_NONNULL_BEGIN
 + (NSURL *)currentExecutableURL;
 + (NSURL *)MFApplicationSupportFolderURL;
 + (NSURL *)configURL;
++ (NSURL *)configJournalURL;
 + (NSURL *)launchdPlistURL;
 + (NSUserDefaults *)defaults;
 @end
@@ -65,6 +65,11 @@ static NSURL *_configURL;
 + (NSURL *)configURL {
     return _configURL;
 }
+static NSURL *_configJournalURL;
++ (NSURL *)configJournalURL {
+    /// Changes that haven't been compacted into config.plist yet. See `Config.m`
+    return _configJournalURL;
+}
 + (NSURL *)launchdPlistURL {
     NSString *launchdPlistRelativePathFromLibrary = [NSString stringWithFormat:@"LaunchAgents/%@.plist", kMFBundleIDHelper];
     NSURL *userLibURL = [NSFileManager.defaultManager URLsForDirectory:NSLibraryDirectory inDomains:NSUserDomainMask][0];
@@ -96,6 +101,7 @@ static NSURL *_configURL;
         NSURL *applicationSupportURL = [NSFileManager.defaultManager URLForDirectory:NSApplicationSupportDirectory inDomain:NSUserDomainMask appropriateForURL:NULL create:YES error:nil];
         _MFApplicationSupportFolderURL = [applicationSupportURL URLByAppendingPathComponent:kMFBundleIDApp];
         _configURL = [_MFApplicationSupportFolderURL URLByAppendingPathComponent:@"config.plist"];
+        _configJournalURL = [_MFApplicationSupportFolderURL URLByAppendingPathComponent:@"config.journal"];
     }
 }
 
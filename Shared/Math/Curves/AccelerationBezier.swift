@@ -19,7 +19,10 @@ class AccelerationBezier: Bezier {
     var preLine: Line
     var postLine: Line
     
-    override init(controlPoints: [P], defaultEpsilon: Double = 0.08) {
+    var cubicApproximation: PiecewiseCubicCurve?
+    /// ^ If this is set, `evaluate(at:)` uses it instead of solving the Bezier inside `xValueRange`. Set it with `approximate(tolerance:)`. See `PiecewiseCubicCurve`.
+    
+    override init(controlPoints: [P], defaultEpsilon: Double = 0.08, intern: Bool = true) {
         
         /// Init lines so we can call super.init. This is the only reason the lines are var and not let. Swift is weird.
         /// See here for an explanation of this problem: https://stackoverflow.com/questions/24021093/error-in-swift-class-property-not-initialized-at-super-init-call
@@ -30,7 +33,7 @@ class AccelerationBezier: Bezier {
         
         /// Init super
         
-        super.init(controlPoints: controlPoints, defaultEpsilon: defaultEpsilon)
+        super.init(controlPoints: controlPoints, defaultEpsilon: defaultEpsilon, intern: intern)
         
         /// Define lines
         
@@ -74,7 +77,26 @@ class AccelerationBezier: Bezier {
         
         /// Found postLine!
         self.postLine = Line.init(a: aPost, b: bPost)
+    }
+    
+    func approximate(tolerance: Double) {
+        
+        /// Lines are already as fast as it gets
+        if self.isLine { return }
+        
+        self.cubicApproximation = self.piecewiseCubicApproximation(tolerance: tolerance)
+    }
+    
+    override func evaluate(at x: Double) -> Double {
+        
+        /// Use the cubic approximation if we have one. It's not bound by `defaultEpsilon` but by the tolerance that was passed to `approximate(tolerance:)`.
+        ///     Callers who want to control the accuracy explicitly can still use `evaluate(at:epsilon:)`
+        
+        if let approximation = cubicApproximation, self.xValueRange.contains(x) {
+            return approximation.evaluate(at: x)
+        }
         
+        return self.evaluate(at: x, epsilon: self.defaultEpsilon)
     }
     
     override func evaluate(at x: Double, epsilon: Double) -> Double {
@@ -88,11 +88,13 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
     let isLine: Bool /// When the Bezier is really just a line we can do some optimzations.
     let lineRepresentation: Line?
     
-    let maxDegreeForPolynomialApproach: Int = 20
-    /// ^ Wikipedia says that "high order curves may lack numeric stability" in polynomial form, and to use Casteljau instead if that happens. Not sure where exactly we should make the cutoff
+    let maxDegreeForPolynomialApproach: Int = BezierShape.maxDegreeForPolynomialApproach
+    
+    let shape: BezierShape? /// Shared between all Beziers with the same control points (unless they were created with `intern: false`). Holds the polynomial coefficients and the x -> t table that `solveForT()` uses for its initial guess. nil for InvalidBezier.
     
     static let defaultDefaultEpsilon = 0.08 /// Default value for `defaultEpsilon`
-    var defaultEpsilon: Double /// Epsilon to be used when none is specified in evaluate(at:) call. This is only a var instead of let because of the debugging function `getMinEpsilon`. If we refactor we shouldn't need it for that either. Should change this.
+    var defaultEpsilon: Double /// Epsilon to be used when none is specified in evaluate(at:) call. This is a var instead of let because of the debugging function `getMinEpsilon` and because `calibrateEpsilon(forResolution:tolerance:)` sets it after init.
+    private(set) var epsilonIsCalibrated = false /// True once `defaultEpsilon` has been set from the calibration cache
     
     var degree: Int {
         controlPoints.count - 1
@@ -154,6 +156,10 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
         let controlPoints: [P] = Bezier.convertPointArraysToPoints(controlPointsArr)
         self.init(controlPoints: controlPoints, defaultEpsilon: defaultEpsilon)
     }
+    @objc convenience init(controlPoints controlPointsArr: [[Double]], defaultEpsilon: Double, intern: Bool) {
+        let controlPoints: [P] = Bezier.convertPointArraysToPoints(controlPointsArr)
+        self.init(controlPoints: controlPoints, defaultEpsilon: defaultEpsilon, intern: intern)
+    }
     
     /// Swift init
     
@@ -185,10 +191,11 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
         
     }
     
-    init(controlPoints controlPointsArg: [P], defaultEpsilon: Double = defaultDefaultEpsilon) {
+    init(controlPoints controlPointsArg: [P], defaultEpsilon: Double = defaultDefaultEpsilon, intern: Bool = true) {
         
         /**
          Core init
+         - Pass `intern: false` for curves that are only created once with these control points and then thrown away. See `BezierShape` for more.
          - You should make sure you only pass in control points describing curves where
             - 1. The x values of the first and last point are the two extreme (minimal and maximal) x values among all control points x values
             - 2. The curves x values are monotonically increasing / decreasing along the y axis, so that there are no x coordinates for which there are several points on the curve
@@ -232,27 +239,27 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
             lineRepresentation = nil
         }
         
-        /// Fill self.controlPoints
+        /// Get shape
+        ///     The shape calculates everything that only depends on the control points. Curves with the same control points share it. See `BezierShape`.
         
-        self.controlPoints = controlPoints
+        let shape = intern ? BezierShape.interned(controlPoints: controlPoints) : BezierShape.uninterned(controlPoints: controlPoints)
+        self.shape = shape
         
-        /// Fill self.controlPointsX and self.controlPointsY
+        /// Fill control points and polynomial coefficients
+        ///     These are just references into the shape's storage (Swift arrays are copy-on-write)
         
-        var controlPointsX: [Double] = []
-        var controlPointsY: [Double] = []
+        self.controlPoints = shape.controlPoints
+        self.controlPointsX = shape.controlPointsX
+        self.controlPointsY = shape.controlPointsY
         
-        for point in controlPoints {
-            controlPointsX.append(point.x)
-            controlPointsY.append(point.y)
-        }
-        
-        self.controlPointsX = controlPointsX
-        self.controlPointsY = controlPointsY
+        self.polynomialCoefficients = shape.polynomialCoefficients
+        self.polynomialCoefficientsX = shape.polynomialCoefficientsX
+        self.polynomialCoefficientsY = shape.polynomialCoefficientsY
         
         /// Get x values of the start and end points!
         
-        let startX = controlPointsX.first!
-        let endX = controlPointsX.last!
+        let startX = shape.controlPointsX.first!
+        let endX = shape.controlPointsX.last!
         
         /// Get x value range
         /// This (and other parts of the code which rely on `xValueRange`) assumes that the curves extreme x values are startX and endX
@@ -260,68 +267,9 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
         
         self.xValueRange = Interval.init(lower: startX, upper: endX)
         
-        /// Set polynomialCoefficients to anything so we can call super.init()
-        /// Only after we called super init, can we access instance properties, which we want to use for calculating the real polynomialCoefficients
-        
-        self.polynomialCoefficients = []
-        self.polynomialCoefficientsX = []
-        self.polynomialCoefficientsY = []
-        
         /// Init super
         
         super.init()
-        
-        /// Precalculate coefficients of the polynomial form of the Bezier Curve
-        /// Formula according to English Wikipedia
-        
-        let Ps: [P] = self.controlPoints /// To make maths formulas more readable
-        
-        /// Fill out the polynomialCoefficient arrays with placeholder values, so we can simply go
-        ///   `array[i] = v`, later, instead of having to use `array.append(v)`
-        ///   This is super ugly but there doesn't seem to be a better way in swift
-        ///     Ideally we'd just allocate space for n+1 elements in the array instead of this but that doesn't seem to be possible in Swift
-        
-        let placeholderPoint = _P(-1, -1)
-        let placeholderPointArray: [P] = [P](repeating: placeholderPoint, count: n+1)
-        let placeholderDoubleArray: [Double] = [Double](repeating: -1.0, count: n+1)
-        
-        self.polynomialCoefficients = placeholderPointArray
-        self.polynomialCoefficientsX = placeholderDoubleArray
-        self.polynomialCoefficientsY = placeholderDoubleArray
-        
-        for j in 0...n {
-            
-            /// Get product
-            
-            var product: Int = 1
-            if 0 <= j-1 { /// Otherwise the range can be be 0...-1 which, just means "skip this" in Maths, but Swift doesn't like it
-                for m in 0...j-1 {
-                    product *= n-m
-                }
-            }
-            
-            /// Get sum
-            
-            var sumX: Double = 0
-            var sumY: Double = 0
-            
-            for i in 0...j {
-                let a: Double = pow(-1, Double(i+j)) / Double(fac(i) * fac(j-i))
-                sumX += a * Ps[i].x
-                sumY += a * Ps[i].y
-            }
-            
-            /// Put it all together
-            
-            let xCoefficient: Double = Double(product) * sumX
-            let yCoefficient: Double = Double(product) * sumY
-            
-            /// Fill instance properties
-            
-            self.polynomialCoefficientsX[j] = xCoefficient
-            self.polynomialCoefficientsY[j] = yCoefficient
-            self.polynomialCoefficients[j] = P.init(x: xCoefficient, y: yCoefficient)
-        }
     }
     
     /// Invalid init
@@ -331,6 +279,7 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
         if !forInvalid { fatalError() }
         
         defaultEpsilon = 0.0
+        shape = nil
         controlPoints = []
         controlPointsX = []
         controlPointsY = []
@@ -350,6 +299,8 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
     private init(copiedFrom other: Bezier, withZone zone: NSZone?) {
         
         defaultEpsilon = other.defaultEpsilon
+        epsilonIsCalibrated = other.epsilonIsCalibrated
+        shape = other.shape
         controlPoints = other.controlPoints
         controlPointsX = other.controlPointsX
         controlPointsY = other.controlPointsY
@@ -388,20 +339,10 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
     
     fileprivate func sampleCurvePolynomial(_ axis: MFAxis, _ t: Double) -> Double {
         
-        let C: [Double] = self.polynomialCoefficients(axis)
-        
-        var sum: Double = 0
-        
         /// Applying Horners Rule for optimization
-        /// Horners Rule: https://www.math10.com/en/algebra/horner.html
         /// Original Formula: https://wikimedia.org/api/rest_v1/media/math/render/svg/1263b2329c8a60a78a433731dfd88b55d6a37eb0
-        for j in (1...n).reversed() {
-            sum += C[j]
-            sum *= t
-        }
-        sum += C[0]
         
-        return sum
+        return Math.evaluatePolynomial(self.polynomialCoefficients(axis), at: t)
     }
     
     fileprivate func sampleCurveCasteljau(_ axis: MFAxis, _ t: Double) -> Double {
@@ -445,25 +386,25 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
     
     private func sampleDerivativePolynomial(_ axis: MFAxis, _ t: Double) -> Double {
         
-        let C: [Double] = self.polynomialCoefficients(axis)
-        
-        var sum: Double = 0
-        
         /// We take the derivative of the original formula and get
         ///     ```
         ///     B'(t) = sum_{j=1}^{n} t^{j-1} * j * C_j
         ///     ```
-        ///     To optimize, we then we apply Horners rule and arrive at the algorithm below
+        ///     `Math.evaluatePolynomialAndDerivative()` computes this alongside B(t) in a single Horner pass
         ///     Also see: original formula: https://wikimedia.org/api/rest_v1/media/math/render/svg/1263b2329c8a60a78a433731dfd88b55d6a37eb0
         
-        for j in (2...n).reversed() {
-            sum += C[j] * Double(j)
-            sum *= t
-        }
-        sum += C[1]
+        return Math.evaluatePolynomialAndDerivative(self.polynomialCoefficients(axis), at: t).derivative
+    }
+    
+    private func sampleCurveAndDerivative(on axis: MFAxis, at t: Double) -> (value: Double, derivative: Double) {
         
-        return sum
+        /// Fused version of `sampleCurve()` and `sampleDerivative()`. Newton's method in `solveForT()` needs both at the same t, and in polynomial form we get them for the price of one.
         
+        if degree <= maxDegreeForPolynomialApproach {
+            return Math.evaluatePolynomialAndDerivative(self.polynomialCoefficients(axis), at: t)
+        } else {
+            return (sampleCurveCasteljau(axis, t), sampleDerivativeExplicit(axis, t))
+        }
     }
     
     private func sampleDerivativeExplicit(_ axis: MFAxis, _ t: Double) -> Double {
@@ -502,9 +443,10 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
         /// This function is mostly copied from AnimationCurve.m by Apple
         /// It's a numerical inverse finder. It basically finds the parameter t for a function value x through educated guesses
         
-        let initialGuess: Double = Math.scale(value: x, from: self.xValueRange, to: .unitInterval)
+        let initialGuess: Double = shape?.initialGuessForT(x: x) ?? Math.scale(value: x, from: self.xValueRange, to: .unitInterval)
         /// ^ Our initial guess for t.
         /// In Apples AnimationCurve.m this was set to x which is an informed guess. We extended the same logic to a general case. (In the Apple implementation, the xValueRange is implicitly 0...1)
+        /// Edit: We now look t up in the inverse table of our `shape` which is much closer to the solution, so Newton usually only needs 1 or 2 iterations. The linear guess is just the fallback for shapes without a table.
         
         /// Try Newtons method
         /// Newtons method finds an input for which the output is 0
@@ -516,14 +458,14 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
         
         for _ in 1...maxNewtonIterations {
             
-            let sampledXShifted = sampleCurve(onAxis: xAxis, atT: t) - x
+            let (sampledX, sampledDerivative) = sampleCurveAndDerivative(on: xAxis, at: t)
+            let sampledXShifted = sampledX - x
             
             let error = abs(sampledXShifted)
             if error < epsilon {
                 return t
             }
             
-            let sampledDerivative = sampleDerivative(on: xAxis, at: t)
             
             if abs(sampledDerivative) < 1e-6 { /// 1e-6 comes from the WebKit implementation I found.
                 break
@@ -603,6 +545,184 @@ import CocoaLumberjackSwift /// Doesn't work for some reason
         }
     }
     
+    @objc func derivativeDyOverDx(atX x: Double, epsilon: Double) -> Double {
+        
+        if isLine {
+            return lineRepresentation!.slope
+        } else {
+            let t: Double = solveForT(x: x, epsilon: epsilon)
+            return derivativeDyOverDx(atT: t)
+        }
+    }
+    
+    // MARK: Piecewise cubic approximation
+    
+    @objc func piecewiseCubicApproximation(tolerance: Double) -> PiecewiseCubicCurve {
+        
+        /// Returns a spline of cubic segments which stays within `tolerance` of this curve on `xValueRange`. Evaluating the spline doesn't need Newton iterations and its cost doesn't depend on the degree of this curve. See `PiecewiseCubicCurve` for more.
+        
+        return PiecewiseCubicCurve(approximating: self, tolerance: tolerance)
+    }
+
+    // MARK: Epsilon calibration
+
+    /// Notes:
+    /// - So far we've been picking `defaultEpsilon` by hand (0.001 for animation curves because 0.08 made them choppy). Smaller epsilons mean more Newton iterations in `solveForT()` for every evaluation, so we want the coarsest epsilon that's still accurate enough.
+    /// - 'Accurate enough' means: If you sample the curve at `resolution` evenly spaced x values, no y value is off by more than `tolerance` from the y value that a very fine `referenceEpsilon` gives. We measure that through `evaluate(at:epsilon:)`, so it includes the effect of the initial guess from `shape`'s inverse table. (Newton returns that guess as-is if it's already within epsilon.)
+    ///     We used to only check that the sampled y values never go backwards. But that doesn't bound the error at all. A curve can be monotonic and still be far away from where it should be.
+    /// - The search starts at the coarse `maxCalibratedEpsilon` and refines from there until the error is within `tolerance`. So it can pick an epsilon that's cheaper than the 0.001 we used to pick by hand, if the shape allows it, or a finer one, if 0.001 isn't accurate enough.
+    /// - Finding the epsilon means sampling the curve thousands of times, so we cache the results by control points, resolution and tolerance, and we do the calibration on a background queue. The first curve with a given shape uses the epsilon it was created with, and curves that are created later with the same shape use the calibrated one. Since ScrollConfig recreates its curves whenever the config or the modifiers change, that happens pretty quickly.
+    ///     Curves that are only created once (like `ScrollConfig.linearCurve`) would never pick up the result that way, so they use `calibrateEpsilonNow(forResolution:tolerance:)` instead.
+    /// - The cache is read under a lock that's only held for the lookup, so creating a curve never waits for a running calibration.
+    /// - `getMinEpsilon()` under `// MARK: Debug` does something similar but it changes `defaultEpsilon` while it's running, so it's not safe to use on a curve that's in use.
+
+    private struct EpsilonCalibrationKey: Hashable {
+        let controlPointsX: [Double]
+        let controlPointsY: [Double]
+        let resolution: Int
+        let tolerance: Double
+    }
+    private static let epsilonCalibrationLock = NSObject()
+    private static var epsilonCalibrationCache: [EpsilonCalibrationKey: Double] = [:] /// Only access this and `epsilonCalibrationsInFlight` under `epsilonCalibrationLock`
+    private static var epsilonCalibrationsInFlight: Set<EpsilonCalibrationKey> = []
+    private static let epsilonCalibrationQueue = DispatchQueue(label: "com.nuebling.mac-mouse-fix.bezier-epsilon-calibration", qos: .utility, attributes: [], autoreleaseFrequency: .inherit, target: nil)
+
+    static let maxCalibratedEpsilon = 0.05 /// Where the search starts. Just below `defaultDefaultEpsilon`, which made animation curves choppy.
+    static let minCalibratedEpsilon = 1e-7
+    static let referenceEpsilon = 1e-10
+
+    @discardableResult @objc func calibrateEpsilon(forResolution resolution: Int, tolerance: Double) -> Bezier {
+
+        /// Sets `defaultEpsilon` to the calibrated epsilon for this curve's shape if it's cached, otherwise starts calibrating it in the background and leaves `defaultEpsilon` alone.
+        /// `tolerance` is in the units of the y axis.
+        /// Only call this right after creating the curve, before it's shared with other threads. Returns self for chaining.
+
+        if isLine { return self } /// Lines don't use epsilon
+
+        let key = EpsilonCalibrationKey(controlPointsX: controlPointsX, controlPointsY: controlPointsY, resolution: resolution, tolerance: tolerance)
+
+        let (cached, shouldCalibrate): (Double?, Bool) = synchronized(Bezier.epsilonCalibrationLock) {
+            if let cached = Bezier.epsilonCalibrationCache[key] {
+                return (cached, false)
+            }
+            let shouldCalibrate = !Bezier.epsilonCalibrationsInFlight.contains(key)
+            if shouldCalibrate {
+                Bezier.epsilonCalibrationsInFlight.insert(key)
+            }
+            return (nil, shouldCalibrate)
+        }
+
+        if shouldCalibrate {
+            /// Calibrate in background
+            Bezier.epsilonCalibrationQueue.async {
+                let epsilon = self.coarsestEpsilon(resolution: resolution, tolerance: tolerance)
+                synchronized(Bezier.epsilonCalibrationLock) {
+                    Bezier.epsilonCalibrationCache[key] = epsilon
+                    Bezier.epsilonCalibrationsInFlight.remove(key)
+                }
+                DDLogDebug("Bezier - calibrated epsilon \(epsilon) for resolution \(resolution), tolerance \(tolerance), controlPoints: \(self.controlPoints)")
+            }
+        }
+
+        if let cached = cached {
+            defaultEpsilon = cached
+            epsilonIsCalibrated = true
+        }
+
+        return self
+    }
+
+    @discardableResult @objc func calibrateEpsilonNow(forResolution resolution: Int, tolerance: Double) -> Bezier {
+
+        /// Like `calibrateEpsilon(forResolution:tolerance:)`, but if there's no cached result, this calibrates on the calling thread instead of in the background.
+        /// Only use this for curves that are created once and kept around. It takes a few ms.
+
+        if isLine { return self }
+
+        let key = EpsilonCalibrationKey(controlPointsX: controlPointsX, controlPointsY: controlPointsY, resolution: resolution, tolerance: tolerance)
+
+        var epsilon = synchronized(Bezier.epsilonCalibrationLock) { Bezier.epsilonCalibrationCache[key] }
+        if epsilon == nil {
+            epsilon = coarsestEpsilon(resolution: resolution, tolerance: tolerance)
+            synchronized(Bezier.epsilonCalibrationLock) {
+                Bezier.epsilonCalibrationCache[key] = epsilon
+            }
+        }
+
+        defaultEpsilon = epsilon!
+        epsilonIsCalibrated = true
+
+        return self
+    }
+
+    func coarsestEpsilon(resolution: Int, tolerance: Double) -> Double {
+
+        /// Searches for the largest epsilon in [minCalibratedEpsilon, maxCalibratedEpsilon] for which `maxError(resolution:epsilon:)` stays within `tolerance`.
+        /// Notes:
+        /// - We start at `maxCalibratedEpsilon` and divide by 8 until the error is within `tolerance`. Then we bisect between that and the last epsilon that was too coarse. We bisect on the log of epsilon since reasonable values span several orders of magnitude.
+        /// - The error isn't perfectly monotonic in epsilon, so we halve the result we found as a safety margin. Halving costs about one extra Newton iteration.
+        /// - Not thread safe with respect to `defaultEpsilon`, but we don't touch that here. `evaluate(at:epsilon:)` doesn't mutate anything.
+
+        let reference = sampleY(resolution: resolution, epsilon: Bezier.referenceEpsilon)
+
+        /// Coarse steps
+        var epsilon = Bezier.maxCalibratedEpsilon
+        var tooCoarse: Double? = nil
+        while maxError(resolution: resolution, epsilon: epsilon, reference: reference) > tolerance {
+            if epsilon <= Bezier.minCalibratedEpsilon {
+                DDLogWarn("Bezier - Couldn't calibrate epsilon. Error at resolution \(resolution) exceeds \(tolerance) even with epsilon \(Bezier.minCalibratedEpsilon). controlPoints: \(controlPoints)")
+                return Bezier.minCalibratedEpsilon
+            }
+            tooCoarse = epsilon
+            epsilon = max(epsilon / 8.0, Bezier.minCalibratedEpsilon)
+        }
+        guard let tooCoarse = tooCoarse else {
+            return Bezier.maxCalibratedEpsilon /// The coarsest epsilon is already good enough
+        }
+
+        /// Refine
+        var good = log(epsilon)
+        var bad = log(tooCoarse)
+
+        for _ in 0..<6 {
+            let middle = (good + bad) / 2.0
+            if maxError(resolution: resolution, epsilon: exp(middle), reference: reference) <= tolerance {
+                good = middle
+            } else {
+                bad = middle
+            }
+        }
+
+        return max(exp(good) / 2.0, Bezier.minCalibratedEpsilon)
+    }
+
+    func maxError(resolution: Int, epsilon: Double, reference: [Double]? = nil) -> Double {
+
+        /// Largest difference between y values sampled with `epsilon` and with `referenceEpsilon`.
+
+        let reference = reference ?? sampleY(resolution: resolution, epsilon: Bezier.referenceEpsilon)
+        let ys = sampleY(resolution: resolution, epsilon: epsilon)
+
+        var result = 0.0
+        for i in ys.indices {
+            result = max(result, abs(ys[i] - reference[i]))
+        }
+        return result
+    }
+
+    private func sampleY(resolution: Int, epsilon: Double) -> [Double] {
+
+        /// Samples at `resolution` evenly spaced intervals, plus the midpoints between them. The midpoints are where the inverse table of `shape` is usually least accurate.
+
+        let n = 2 * resolution
+        var result = [Double](repeating: 0, count: n + 1)
+        for i in 0...n {
+            let x = Math.scale(value: Double(i), from: Interval(0, Double(n)), to: xValueRange)
+            result[i] = evaluate(at: x, epsilon: epsilon)
+        }
+        return result
+    }
+
     // MARK: Other Interface
     
     var exitSlope: Double {
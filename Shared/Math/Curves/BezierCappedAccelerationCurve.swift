@@ -48,10 +48,11 @@ class BezierCappedAccelerationCurve: AccelerationBezier {
     /// This class just adds an initializer for AccelerationBezier. Maybe it shouldn't be it's own class at all.
     ///     We made it its own class because that was necessary for the old implementation which you can find below.
     
-    @objc init(xMin: Double, yMin: Double, xMax: Double, yMax: Double, curvature curvatureArg: Double, reduceToCubic: Bool = false, defaultEpsilon: Double = 0.08) {
+    @objc init(xMin: Double, yMin: Double, xMax: Double, yMax: Double, curvature curvatureArg: Double, reduceToCubic: Bool = false, defaultEpsilon: Double = 0.08, approximationTolerance: Double = 0.01) {
         
         /// NOTES:
         /// Not sure the 0.08 default epsilon makes sense here
+        /// `approximationTolerance` is in units of the y axis. The curve is evaluated through a piecewise cubic approximation that stays within that tolerance, because evaluating the degree `curvature + 1` Bezier directly gets slow for high curvatures. Pass 0 to always evaluate the Bezier directly.
         
         let degree = curvatureArg + 1
         assert(degree >= 1)
@@ -66,6 +67,7 @@ class BezierCappedAccelerationCurve: AccelerationBezier {
             if reduceToCubic {
                 let isFirstThree = i <= 2
                 if !isFirstThree && !isLast {
+                    i += 1 /// Need to increment before `continue`, otherwise this loops forever
                     continue
                 }
             }
@@ -85,6 +87,10 @@ class BezierCappedAccelerationCurve: AccelerationBezier {
         }
         
         super.init(controlPoints: points, defaultEpsilon: defaultEpsilon)
+        
+        if approximationTolerance > 0 {
+            self.approximate(tolerance: approximationTolerance)
+        }
     }
 }
 
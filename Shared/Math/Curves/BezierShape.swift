@@ -0,0 +1,221 @@
+//
+// --------------------------------------------------------------------------
+// BezierShape.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// The immutable, precomputed part of a `Bezier` – everything that only depends on the control points.
+///
+/// __Why__
+/// - ScrollConfig recreates its animation curves whenever the config or the active modifiers change, and the animator creates a new HybridCurve on every scrollwheel tick. Lots of those Beziers have exactly the same control points. Before, every one of them calculated its polynomial coefficients from scratch and stored its own copy.
+/// - Every `Bezier.evaluate(at:)` needs to find t for the given x with Newton's method. We used to start Newton at a linear guess, which can be quite far off for curves with flat sections (like the ease-out baseCurves). Here, we precompute a small x -> t table once per shape, so Newton starts very close to the solution and usually converges after 1 or 2 iterations.
+///
+/// __How__
+/// - Shapes are interned: `BezierShape.interned(controlPoints:)` returns the existing shape if a shape with the same control points is still alive. The table holds the shapes weakly, so a shape is freed once the last Bezier using it is freed. Entries for freed shapes are pruned every `internTablePruneInterval` insertions.
+/// - Interning isn't free: Building the key allocates, the lookup goes through `internQueue`, and a miss builds the inverse table. That's only worth it if the shape is reused. One-off curves, like the speedSmoothing baseCurve that Scroll.m creates with a new control point on every tick, should use `BezierShape.uninterned(controlPoints:)` (through Bezier's `intern:` argument) instead. That skips the lookup and the inverse table. Newton then starts from the linear guess like it used to.
+/// - The inverse table is built by sampling x(t) on a fine grid of t values and then linearly interpolating t at evenly spaced x values. That only works because our curves are monotonic in x (see Bezier `init`). If they aren't, the guesses are just worse and Newton has to do more work – the result is still correct.
+///
+/// __Notes__
+/// - For curves with more than `maxDegreeForPolynomialApproach` we don't build an inverse table, since sampling them would need the slow Casteljau algorithm.
+
+import Foundation
+
+@objc final class BezierShape: NSObject {
+
+    /// Constants
+
+    static let maxDegreeForPolynomialApproach: Int = 20
+    /// ^ Wikipedia says that "high order curves may lack numeric stability" in polynomial form, and to use Casteljau instead if that happens. Not sure where exactly we should make the cutoff
+
+    static let inverseTableSize = 64
+
+    /// Storage
+
+    let controlPoints: [P]
+    let controlPointsX: [Double]
+    let controlPointsY: [Double]
+
+    let polynomialCoefficients: [P]
+    let polynomialCoefficientsX: [Double]
+    let polynomialCoefficientsY: [Double]
+
+    private let inverseTable: [Double] /// t values at `inverseTableSize + 1` evenly spaced x values from the first to the last control point. Empty if we couldn't build it.
+
+    /// Interning
+
+    private static let internTable = NSMapTable<NSArray, BezierShape>(keyOptions: .strongMemory, valueOptions: .weakMemory)
+    private static let internQueue = DispatchQueue(label: "com.nuebling.mac-mouse-fix.bezier-shapes", qos: .userInteractive, attributes: [], autoreleaseFrequency: .inherit, target: nil)
+    private static var insertionsSinceLastPrune = 0 /// Only access on `internQueue`
+    static let internTablePruneInterval = 64
+
+    static var nOfInternTableEntries: Int { /// For testing. Includes entries for freed shapes that haven't been pruned, yet.
+        internQueue.sync { internTable.count }
+    }
+
+    static func interned(controlPoints: [P]) -> BezierShape {
+
+        /// Get key
+        ///     NSArray hashes and compares its elements by value, which is what we want.
+        var keyElements: [NSNumber] = []
+        keyElements.reserveCapacity(2 * controlPoints.count)
+        for p in controlPoints {
+            keyElements.append(NSNumber(value: Double(p.x)))
+            keyElements.append(NSNumber(value: Double(p.y)))
+        }
+        let key = keyElements as NSArray
+
+        /// Look up or create
+        return internQueue.sync {
+            if let existing = internTable.object(forKey: key) {
+                return existing
+            }
+            let new = BezierShape(controlPoints: controlPoints, buildInverseTable: true)
+            internTable.setObject(new, forKey: key)
+            insertionsSinceLastPrune += 1
+            if insertionsSinceLastPrune >= internTablePruneInterval {
+                pruneInternTable()
+            }
+            return new
+        }
+    }
+
+    static func uninterned(controlPoints: [P]) -> BezierShape {
+        /// For curves that are only used once. See `__How__` above.
+        return BezierShape(controlPoints: controlPoints, buildInverseTable: false)
+    }
+
+    private static func pruneInternTable() {
+
+        /// Removes the keys whose shapes have been freed
+        ///     NSMapTable doesn't reliably remove those on its own, so without this, the keys of one-off shapes would pile up.
+        ///     Only call this on `internQueue`.
+
+        for key in internTable.keyEnumerator().allObjects {
+            if let key = key as? NSArray, internTable.object(forKey: key) == nil {
+                internTable.removeObject(forKey: key)
+            }
+        }
+        insertionsSinceLastPrune = 0
+    }
+
+    /// Init
+
+    private init(controlPoints: [P], buildInverseTable: Bool) {
+
+        /// Store control points
+
+        self.controlPoints = controlPoints
+        self.controlPointsX = controlPoints.map { Double($0.x) }
+        self.controlPointsY = controlPoints.map { Double($0.y) }
+
+        /// Precalculate coefficients of the polynomial form of the Bezier Curve
+        /// Formula according to English Wikipedia
+
+        let Ps: [P] = controlPoints /// To make maths formulas more readable
+        let n = controlPoints.count - 1
+
+        var coefficientsX = [Double](repeating: -1.0, count: n+1)
+        var coefficientsY = [Double](repeating: -1.0, count: n+1)
+
+        for j in 0...n {
+
+            /// Get product
+
+            var product: Int = 1
+            if 0 <= j-1 { /// Otherwise the range can be be 0...-1 which, just means "skip this" in Maths, but Swift doesn't like it
+                for m in 0...j-1 {
+                    product *= n-m
+                }
+            }
+
+            /// Get sum
+
+            var sumX: Double = 0
+            var sumY: Double = 0
+
+            for i in 0...j {
+                let a: Double = pow(-1, Double(i+j)) / Double(fac(i) * fac(j-i))
+                sumX += a * Ps[i].x
+                sumY += a * Ps[i].y
+            }
+
+            /// Put it all together
+
+            coefficientsX[j] = Double(product) * sumX
+            coefficientsY[j] = Double(product) * sumY
+        }
+
+        self.polynomialCoefficientsX = coefficientsX
+        self.polynomialCoefficientsY = coefficientsY
+        self.polynomialCoefficients = zip(coefficientsX, coefficientsY).map { P(x: $0, y: $1) }
+
+        /// Build inverse table
+
+        self.inverseTable = buildInverseTable ? BezierShape.buildInverseTable(coefficientsX: coefficientsX, degree: n) : []
+
+        /// Init super
+        super.init()
+    }
+
+    /// Inverse
+
+    func initialGuessForT(x: Double) -> Double? {
+
+        /// Returns an approximation of t for the given x, or nil if we don't have an inverse table for this shape.
+
+        guard !inverseTable.isEmpty else { return nil }
+
+        let x0 = controlPointsX.first!
+        let x1 = controlPointsX.last!
+        guard x0 != x1 else { return nil }
+
+        /// Get position in table
+        var u = (x - x0) / (x1 - x0) * Double(BezierShape.inverseTableSize)
+        if u < 0 { u = 0 }
+        else if u > Double(BezierShape.inverseTableSize) { u = Double(BezierShape.inverseTableSize) }
+
+        /// Interpolate
+        let i = min(Int(u), BezierShape.inverseTableSize - 1)
+        let f = u - Double(i)
+        return inverseTable[i] + f * (inverseTable[i+1] - inverseTable[i])
+    }
+
+    private static func buildInverseTable(coefficientsX: [Double], degree: Int) -> [Double] {
+
+        guard degree >= 2 && degree <= maxDegreeForPolynomialApproach else { return [] } /// Lines don't need this
+
+        /// Sample x(t)
+        ///     Normalized so the first control point is at 0 and the last at 1. That way it works for curves that are decreasing in x as well.
+
+        let sampleCount = 4 * inverseTableSize
+        let x0 = Math.evaluatePolynomial(coefficientsX, at: 0.0)
+        let x1 = Math.evaluatePolynomial(coefficientsX, at: 1.0)
+        guard x0 != x1 else { return [] }
+
+        var uSamples = [Double](repeating: 0, count: sampleCount + 1)
+        for k in 0...sampleCount {
+            let t = Double(k) / Double(sampleCount)
+            uSamples[k] = (Math.evaluatePolynomial(coefficientsX, at: t) - x0) / (x1 - x0)
+        }
+
+        /// Invert
+        ///     Walk the samples and linearly interpolate t for each evenly spaced u
+
+        var table = [Double](repeating: 0, count: inverseTableSize + 1)
+        var k = 0
+        for i in 0...inverseTableSize {
+            let u = Double(i) / Double(inverseTableSize)
+            while k < sampleCount - 1 && uSamples[k+1] < u {
+                k += 1
+            }
+            let du = uSamples[k+1] - uSamples[k]
+            let f = du > 0 ? min(max((u - uSamples[k]) / du, 0), 1) : 0
+            table[i] = (Double(k) + f) / Double(sampleCount)
+        }
+
+        return table
+    }
+}
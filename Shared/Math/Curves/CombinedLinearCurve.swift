@@ -12,6 +12,10 @@ import Foundation
 import Cocoa
 
 struct CombinedLinearCurve {
+    
+    /// Notes:
+    /// - We precompute the slope of every segment at init, so evaluating is just finding the segment + one multiply-add.
+    /// - Finding the segment used to be a linear scan over `points`. Now it's O(1) if the x values are equidistant (which they are when you use `init(yValues:)`), and a binary search otherwise.
 
     let points: [P]
     
@@ -20,6 +24,11 @@ struct CombinedLinearCurve {
     let minY: Double
     let maxY: Double
     
+    /// Precomputed lookup data
+    private let slopes: [Double]        /// `slopes[i]` is the slope between `points[i]` and `points[i+1]`
+    private let uniformStep: Double?    /// Distance between consecutive x values, if they are all the same. Lets us find the segment by dividing instead of searching
+    private let isIncreasing: Bool      /// y values are strictly ascending -> `evaluate(atY:)` can binary search
+    
     init(yValues: [Double]) {
         /// Create points automatically just from yValues. x values will be equidistant between 0 and 1. This should be useful for defining NSSliders.
         
@@ -61,6 +70,29 @@ struct CombinedLinearCurve {
         self.minY = _minY
         self.maxY = _maxY
         
+        /// Precompute slopes, and check whether x values are equidistant and y values are ascending
+        
+        var slopes: [Double] = []
+        slopes.reserveCapacity(points.count - 1)
+        
+        let step = (_maxX - _minX) / Double(points.count - 1)
+        var isUniform = true
+        var isIncreasing = true
+        
+        for i in 0..<points.count-1 {
+            let p1 = points[i]
+            let p2 = points[i+1]
+            slopes.append((p2.y - p1.y) / (p2.x - p1.x))
+            
+            let expectedX = _minX + Double(i+1) * step
+            if abs(p2.x - expectedX) > step * 1e-9 { isUniform = false }
+            if !(p1.y < p2.y) { isIncreasing = false }
+        }
+        
+        self.slopes = slopes
+        self.uniformStep = isUniform ? step : nil
+        self.isIncreasing = isIncreasing
+        
         /// Store points
         self.points = points
     }
@@ -71,35 +103,19 @@ struct CombinedLinearCurve {
         
         assert(minX <= x && x <= maxX)
         
-        /// Do calculations
-            
-        /// Find two points that x lies between
-        
-        var p1: P? = nil
-        var p2: P? = nil
-        for i in 0..<points.count {
-            if x < points[i].x {
-                p1 = points[i-1]
-                p2 = points[i]
-                break;
-            }
-        }
-        if p1 == nil {
-            if x == points.last!.x {
-                p1 = points[points.count-2]
-                p2 = points[points.count-1]
-            }
-        }
+        /// Find the segment that x lies in & get y
         
-        guard let p1 = p1 else { fatalError() }
-        guard let p2 = p2 else { fatalError() }
-
-        /// Get y
+        let i = segmentIndex(forX: x)
+        let p1 = points[i]
+        
+        return p1.y + (x - p1.x) * slopes[i]
+    }
+    
+    func evaluate(atX xs: [Double]) -> [Double] {
         
-        let unitX = (x - p1.x) / (p2.x - p1.x)
-        let y = unitX * (p2.y - p1.y) + p1.y
+        /// Batched version of `evaluate(atX:)`
         
-        return y
+        return xs.map { x in evaluate(atX: x) }
     }
     
     func evaluate(atY y: Double) -> Double {
@@ -108,30 +124,72 @@ struct CombinedLinearCurve {
         
         assert(minY <= y && y <= maxY)
         
-        /// Do calculations
-        
         /// Find two points that y lies between
         ///     This is ambiguous if the curve goes up and down
+        ///     If the curve is strictly increasing it's not ambiguous and we can binary search. Otherwise we fall back to a linear scan that returns the first match.
         
-        var p1: P? = nil
-        var p2: P? = nil
-        for i in 0..<points.count-1 {
-            if points[i].y <= y && y <= points[i+1].y {
-                p1 = points[i]
-                p2 = points[i+1]
-                break
+        var i: Int? = nil
+        
+        if isIncreasing {
+            var lo = 0
+            var hi = points.count - 2
+            while lo < hi {
+                let mid = (lo + hi + 1) / 2
+                if points[mid].y <= y { lo = mid } else { hi = mid - 1 }
+            }
+            i = lo
+        } else {
+            for j in 0..<points.count-1 {
+                if points[j].y <= y && y <= points[j+1].y {
+                    i = j
+                    break
+                }
             }
         }
         
-        guard let p1 = p1 else { fatalError() }
-        guard let p2 = p2 else { fatalError() }
+        guard let i = i else { fatalError() }
         
         /// Get x
         
+        let p1 = points[i]
+        let p2 = points[i+1]
+        
         let unitY = (y - p1.y) / (p2.y - p1.y)
         let x = unitY * (p2.x - p1.x) + p1.x
         
         return x
     }
     
+    func evaluate(atY ys: [Double]) -> [Double] {
+        
+        /// Batched version of `evaluate(atY:)`
+        
+        return ys.map { y in evaluate(atY: y) }
+    }
+    
+    private func segmentIndex(forX x: Double) -> Int {
+        
+        /// Returns i such that x lies between `points[i].x` and `points[i+1].x`
+        
+        let lastSegment = points.count - 2
+        
+        if let step = uniformStep {
+            
+            /// O(1) lookup
+            let i = Int((x - minX) / step)
+            return min(max(i, 0), lastSegment)
+            
+        } else {
+            
+            /// Binary search for the last point with `point.x <= x`
+            var lo = 0
+            var hi = lastSegment
+            while lo < hi {
+                let mid = (lo + hi + 1) / 2
+                if points[mid].x <= x { lo = mid } else { hi = mid - 1 }
+            }
+            return lo
+        }
+    }
+    
 }
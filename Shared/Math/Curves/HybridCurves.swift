@@ -66,6 +66,9 @@ import CocoaLumberjackSwift
         self.dragExponent = dragExponent
         self.stopSpeed = stopSpeed
         
+        /// Cache phase boundary
+        updateDragStartTimeUnit()
+        
         /// Debug
         DDLogDebug(String(format: "Created BezierHybridCurve with - duration: %.3f, distance: %.3f", baseDuration/duration, baseDistance/distance))
     }
@@ -244,6 +247,9 @@ import CocoaLumberjackSwift
         self.dragCoefficient = dragCoefficient
         self.dragExponent = dragExponent
         self.stopSpeed = stopSpeed
+        
+        /// Cache phase boundary
+        updateDragStartTimeUnit()
     }
     
     /// Init helper
@@ -349,6 +355,8 @@ import CocoaLumberjackSwift
         let v0 = baseCurve.exitSlope * distance / duration
         self.dragCurve = HybridCurve.getDragCurve(initialSpeed: v0, stopSpeed: stopSpeed, coefficient: dragCoefficient, exponent: dragExponent)
         
+        /// Cache phase boundary
+        updateDragStartTimeUnit()
     }
 }
 
@@ -397,6 +405,16 @@ class HybridCurve: Curve {
     @objc var duration: Double { timeInterval.length }
     @objc var distance: Double { distanceInterval.length }
     
+    /// Phase boundary
+    ///     The point in unit animation time where the baseCurve ends and the dragCurve takes over.
+    ///     Going through `baseDuration / duration` means going through several computed Intervals and the dragCurve. The animator needs this every frame, so subclasses compute it once at the end of their init by calling `updateDragStartTimeUnit()`.
+    
+    @objc private(set) var dragStartTimeUnit: Double = 1.0
+    
+    fileprivate func updateDragStartTimeUnit() {
+        dragStartTimeUnit = duration == 0 ? 1.0 : baseDuration / duration
+    }
+    
     /// Init
     
     override init() {
@@ -440,7 +458,7 @@ class HybridCurve: Curve {
         
         let result: Double
         
-        if x <= baseDuration / duration {
+        if x <= dragStartTimeUnit {
             
             /// Evaluate baseCurve
             
@@ -464,10 +482,10 @@ class HybridCurve: Curve {
     }
     
     /// Evaluate - helpers
-    var baseTimeIntervalUnit: Interval      { Interval(start: 0, end: baseDuration / duration) }
+    var baseTimeIntervalUnit: Interval      { Interval(start: 0, end: dragStartTimeUnit) }
     var baseDistanceIntervalUnit: Interval  { Interval(start: 0, end: baseDistance / distance) }
     
-    var dragTimeIntervalUnit: Interval      { Interval(start: baseDuration / duration, end: 1) }
+    var dragTimeIntervalUnit: Interval      { Interval(start: dragStartTimeUnit, end: 1) }
     var dragDistanceIntervalUnit: Interval  { Interval(start: baseDistance / distance, end: 1) }
     
     /// Other interface
@@ -475,7 +493,7 @@ class HybridCurve: Curve {
     
     @objc func subCurve(at x: Double) -> MFHybridSubCurve {
         
-        if x <= baseDuration / duration {
+        if x <= dragStartTimeUnit {
             return kMFHybridSubCurveBase
         } else {
             return kMFHybridSubCurveDrag
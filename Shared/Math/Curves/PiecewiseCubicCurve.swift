@@ -0,0 +1,159 @@
+//
+// --------------------------------------------------------------------------
+// PiecewiseCubicCurve.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Approximates an arbitrary curve y(x) on a finite x range with a spline made up of cubic Hermite segments.
+///
+/// __Why__
+/// - Evaluating a Bezier at x means first solving for t with Newton's method (see `Bezier.solveForT()`) and each Newton step evaluates a polynomial of degree n twice. For the high-degree curves that `BezierCappedAccelerationCurve` creates, that's quite a bit of work for every scroll tick.
+/// - A piecewise cubic is evaluated by finding the segment (binary search over a handful of breakpoints) and then doing a single cubic Horner evaluation. No iteration, no dependence on the degree of the original curve.
+///
+/// __How__
+/// - We fit a cubic Hermite segment which matches the value and the slope of the original curve at both ends of the segment. If the segment deviates from the original curve by more than `tolerance` at any of the checked sample points, we split it in the middle and try again for both halves.
+/// - Since each segment matches the slope of its neighbours, the spline is C1-continuous. For the monotonic acceleration curves we use this for, it also stays monotonic in practice.
+/// - `maxDeviation` is the largest deviation we measured while checking the segments. It's measured at sample points, not proven, but with `samplesPerSegment` points per segment that's plenty accurate for smooth curves.
+///
+/// __Notes__
+/// - Outside the x range we clip x to the range. Callers like `AccelerationBezier` do their own extrapolation.
+
+import Foundation
+import CocoaLumberjackSwift
+
+@objc class PiecewiseCubicCurve: Curve {
+
+    /// Storage
+
+    let breakpoints: [Double]   /// x values where the segments start and end. `breakpoints.count == segmentCount + 1`
+    let coefficients: [Double]  /// 4 coefficients per segment, lowest order first. Segment `i` evaluates to `c0 + c1*u + c2*u^2 + c3*u^3` where `u = x - breakpoints[i]`
+
+    @objc let maxDeviation: Double
+    @objc var segmentCount: Int { breakpoints.count - 1 }
+
+    /// Constants
+
+    static let samplesPerSegment = 8
+    static let defaultMaxSegments = 64
+
+    /// Init
+
+    @objc convenience init(approximating bezier: Bezier, tolerance: Double, maxSegments: Int = defaultMaxSegments) {
+
+        /// Notes:
+        /// - We evaluate the Bezier with a tiny epsilon here, since this only happens once and every bit of inaccuracy would just add on top of `tolerance`.
+
+        let epsilon = 1e-9
+
+        self.init(xRange: bezier.xValueRange,
+                  tolerance: tolerance,
+                  maxSegments: maxSegments,
+                  value: { x in bezier.evaluate(at: x, epsilon: epsilon) },
+                  slope: { x in bezier.derivativeDyOverDx(atX: x, epsilon: epsilon) })
+    }
+
+    init(xRange: Interval, tolerance: Double, maxSegments: Int = defaultMaxSegments, value f: (Double) -> Double, slope df: (Double) -> Double) {
+
+        /// Validate
+        assert(tolerance > 0)
+        assert(maxSegments >= 1)
+
+        /// Fit segments
+        ///     We subdivide left-to-right with an explicit stack, so the resulting segments are already sorted.
+
+        var breakpoints: [Double] = [xRange.lower]
+        var coefficients: [Double] = []
+        var maxDeviation: Double = 0.0
+
+        var stack: [(x0: Double, x1: Double)] = [(xRange.lower, xRange.upper)]
+
+        while let (x0, x1) = stack.popLast() {
+
+            let y0 = f(x0), y1 = f(x1)
+            let m0 = df(x0), m1 = df(x1)
+            let c = PiecewiseCubicCurve.hermiteCoefficients(x0, x1, y0, y1, m0, m1)
+
+            /// Measure deviation
+            var deviation: Double = 0.0
+            for k in 1...PiecewiseCubicCurve.samplesPerSegment {
+                let x = x0 + (x1 - x0) * Double(k) / Double(PiecewiseCubicCurve.samplesPerSegment + 1)
+                deviation = max(deviation, abs(PiecewiseCubicCurve.horner(c, x - x0) - f(x)))
+            }
+
+            /// Split or accept
+            let segmentBudgetLeft = (breakpoints.count - 1) + stack.count + 2 <= maxSegments
+            if deviation > tolerance && segmentBudgetLeft {
+                let xMid = (x0 + x1) / 2.0
+                stack.append((xMid, x1))
+                stack.append((x0, xMid)) /// Pushed last so it's processed first
+            } else {
+                breakpoints.append(x1)
+                coefficients.append(contentsOf: [c.0, c.1, c.2, c.3])
+                maxDeviation = max(maxDeviation, deviation)
+            }
+        }
+
+        /// Store
+        self.breakpoints = breakpoints
+        self.coefficients = coefficients
+        self.maxDeviation = maxDeviation
+
+        super.init()
+
+        /// Validate
+        if maxDeviation > tolerance {
+            DDLogWarn("PiecewiseCubicCurve couldn't meet tolerance \(tolerance) with \(maxSegments) segments. Max deviation: \(maxDeviation)")
+        }
+    }
+
+    /// Evaluate
+
+    override func evaluate(at xArg: Double) -> Double {
+
+        /// Clip
+        let x = min(max(xArg, breakpoints[0]), breakpoints[breakpoints.count - 1])
+
+        /// Find segment
+        ///     Binary search for the last breakpoint that is <= x
+        var lo = 0
+        var hi = breakpoints.count - 2
+        while lo < hi {
+            let mid = (lo + hi + 1) / 2
+            if breakpoints[mid] <= x {
+                lo = mid
+            } else {
+                hi = mid - 1
+            }
+        }
+
+        /// Evaluate segment
+        let u = x - breakpoints[lo]
+        let i = 4 * lo
+        return ((coefficients[i+3] * u + coefficients[i+2]) * u + coefficients[i+1]) * u + coefficients[i]
+    }
+
+    /// Helper functions
+
+    private static func hermiteCoefficients(_ x0: Double, _ x1: Double, _ y0: Double, _ y1: Double, _ m0: Double, _ m1: Double) -> (Double, Double, Double, Double) {
+
+        /// Cubic in local coordinate `u = x - x0` that passes through (x0, y0) and (x1, y1) with slopes m0 and m1
+        ///     Src: https://en.wikipedia.org/wiki/Cubic_Hermite_spline (expanded into monomial form)
+
+        let h = x1 - x0
+        let d = (y1 - y0) / h
+
+        let c0 = y0
+        let c1 = m0
+        let c2 = (3*d - 2*m0 - m1) / h
+        let c3 = (m0 + m1 - 2*d) / (h*h)
+
+        return (c0, c1, c2, c3)
+    }
+
+    private static func horner(_ c: (Double, Double, Double, Double), _ u: Double) -> Double {
+        return ((c.3 * u + c.2) * u + c.1) * u + c.0
+    }
+}
@@ -106,12 +106,8 @@ import Foundation
         
         let xClipped = SharedUtilitySwift.clip(x, betweenLow: p0.x, high: p1.x)
         
-        var y = 0.0
-        var exponent = 0.0
-        for c in coeffs {
-            y += c*pow(xClipped, exponent)
-            exponent += 1.0
-        }
+        /// Note: We used to call `pow()` for every coefficient here. Horner's rule gets by with one multiply-add per coefficient.
+        let y = Math.evaluatePolynomial(coeffs, at: xClipped)
         
         return y
     }
@@ -186,6 +186,47 @@ import CocoaLumberjackSwift
         return result
     }
     
+    /// Polynomials
+    ///     `coefficients` are ordered lowest degree first, so `coefficients[i]` belongs to `x^i`
+    ///     These are used in the curve evaluation hot paths, so we use Horner's rule and read through unsafe buffers to avoid the bounds checks. (Horners Rule: https://www.math10.com/en/algebra/horner.html)
+    
+    @inline(__always) static func evaluatePolynomial(_ coefficients: [Double], at x: Double) -> Double {
+        
+        return coefficients.withUnsafeBufferPointer { c in
+            
+            var i = c.count - 1
+            if i < 0 { return 0.0 }
+            
+            var y = c[i]
+            while i > 0 {
+                i -= 1
+                y = y * x + c[i]
+            }
+            return y
+        }
+    }
+    
+    @inline(__always) static func evaluatePolynomialAndDerivative(_ coefficients: [Double], at x: Double) -> (value: Double, derivative: Double) {
+        
+        /// Evaluates the polynomial and its first derivative in a single Horner pass.
+        ///     This is about half the work of evaluating both separately, which is nice for Newton's method.
+        
+        return coefficients.withUnsafeBufferPointer { c in
+            
+            var i = c.count - 1
+            if i < 0 { return (0.0, 0.0) }
+            
+            var y = c[i]
+            var dy = 0.0
+            while i > 0 {
+                i -= 1
+                dy = dy * x + y
+                y = y * x + c[i]
+            }
+            return (y, dy)
+        }
+    }
+    
     @objc class func nthroot(value: Double, _ n: Double) -> Double {
         /// Src: https://stackoverflow.com/a/37028926/10601702
         
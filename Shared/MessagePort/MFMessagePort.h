@@ -16,6 +16,7 @@ NS_ASSUME_NONNULL_BEGIN
 + (void)load_Manual;
 
 + (NSObject *_Nullable)sendMessage:(NSString * _Nonnull)message withPayload:(NSObject <NSCoding> * _Nullable)payload waitForReply:(BOOL)replyExpected;
++ (NSObject *_Nullable)handleMessage:(NSString *)message withPayload:(NSObject *_Nullable)payload;
 
 @end
 
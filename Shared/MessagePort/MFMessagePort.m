@@ -20,6 +20,7 @@
 #import "Locator.h"
 #import "HelperServices.h"
 #import "Locator.h"
+#import "MFSharedStatus.h"
 
 #if IS_MAIN_APP
 #import "Mac_Mouse_Fix-Swift.h"
@@ -46,7 +47,24 @@ static CFDataRef _Nullable didReceiveMessage(CFMessagePortRef port, SInt32 messa
     NSString *message = messageDict[kMFMessageKeyMessage];
     NSObject *payload = messageDict[kMFMessageKeyPayload];
     
-    DDLogInfo(@"Received Message: %@ with payload: %@", message, payload);
+    NSObject *response = [MFMessagePort handleMessage:message withPayload:payload];
+    
+    if (response != nil) {
+         return (__bridge_retained CFDataRef)[NSKeyedArchiver archivedDataWithRootObject:response];
+     }
+
+     return NULL;
+}
+
++ (NSObject *_Nullable)handleMessage:(NSString *)message withPayload:(NSObject *_Nullable)payload {
+    
+    /// Split out of `didReceiveMessage()` so messages that arrive through MFSharedStatus's feedback ring are handled exactly like the ones arriving through the port.
+    
+    if ([message isEqualToString:@"configDelta"]) {
+        DDLogInfo(@"Received Message: %@ with sections: %@", message, [(NSDictionary *)payload allKeys]); /// The sections can be large (Remaps), so don't log their contents
+    } else {
+        DDLogInfo(@"Received Message: %@ with payload: %@", message, payload);
+    }
     
     NSObject *response = nil;
     
@@ -93,14 +111,18 @@ static CFDataRef _Nullable didReceiveMessage(CFMessagePortRef port, SInt32 messa
             [AuthorizeAccessibilityView remove];
             
             /// Notify rest of the app
+            [HelperServices helperDidReportEnabled:YES payload:(NSDictionary *)payload];
             [EnabledState.shared reactToDidBecomeEnabled];
         }
         
         
     } else if ([message isEqualToString:@"helperDisabled"]) {
+        [HelperServices helperDidReportEnabled:NO payload:nil];
         [EnabledState.shared reactToDidBecomeDisabled];
     } else if ([message isEqualToString:@"configFileChanged"]) {
         [Config loadFileAndUpdateStates];
+    } else if ([message isEqualToString:@"configDelta"]) {
+        [Config applyDelta:(NSDictionary *)payload];
     }
     
 #elif IS_HELPER
@@ -109,6 +131,8 @@ static CFDataRef _Nullable didReceiveMessage(CFMessagePortRef port, SInt32 messa
     
     if ([message isEqualToString:@"configFileChanged"]) {
         [Config loadFileAndUpdateStates];
+    } else if ([message isEqualToString:@"configDelta"]) {
+        [Config applyDelta:(NSDictionary *)payload];
     } else if ([message isEqualToString:@"terminate"]) {
 //        [NSApp.delegate applicationWillTerminate:[[NSNotification alloc] init]]; /// This creates an infinite loop or something? The statement below is never executed.
         [NSApp terminate:NULL];
@@ -144,6 +168,11 @@ static CFDataRef _Nullable didReceiveMessage(CFMessagePortRef port, SInt32 messa
         
     } else if ([message isEqualToString:@"getBundleVersion"]) {
         response = @(Locator.bundleVersion);
+    } else if ([message isEqualToString:@"getHelperInfo"]) {
+        response = @{
+            @"bundleVersion": @(Locator.bundleVersion),
+            @"pid": @(NSProcessInfo.processInfo.processIdentifier),
+        };
 //    } else if ([message isEqualToString:@"getBundleVersion"]) {
 //        response = @(Locator.bundleVersion);
     } else {
@@ -154,11 +183,7 @@ static CFDataRef _Nullable didReceiveMessage(CFMessagePortRef port, SInt32 messa
     abort();
 #endif
     
-    if (response != nil) {
-         return (__bridge_retained CFDataRef)[NSKeyedArchiver archivedDataWithRootObject:response];
-     }
-
-     return NULL;
+    return response;
 }
 
 
@@ -190,6 +215,9 @@ static CFDataRef _Nullable didReceiveMessage(CFMessagePortRef port, SInt32 messa
     
     DDLogInfo(@"Created localPort: %@", localPort);
     
+    /// Also set up the shared memory status channel
+    MFSharedStatusLoad();
+    
     /// Setting the name here instead of when creating the port creates some super weird behavior, too.
 //    CFMessagePortSetName(localPort, CFSTR("com.nuebling.mousefix.port"));
     
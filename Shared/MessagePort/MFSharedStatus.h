@@ -0,0 +1,67 @@
+//
+// --------------------------------------------------------------------------
+// MFSharedStatus.h
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Shared memory between Helper and mainApp. See MFSharedStatus.m for discussion.
+
+#import <Foundation/Foundation.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#pragma mark - Types
+
+#define kMFSharedStatusDeviceNameCapacity 64
+
+typedef struct {
+    uint32_t helperPid;                 /// 0 if no helper has published, yet
+    uint32_t helperBundleVersion;
+    uint8_t  helperIsLockedDown;
+    uint8_t  addModeIsEnabled;
+    uint8_t  keyCaptureModeIsEnabled;
+    uint32_t activeDeviceButtonCount;
+    char     activeDeviceName[kMFSharedStatusDeviceNameCapacity]; /// UTF-8, null-terminated, might be truncated
+    uint64_t keyboardModifierFlags;
+    uint32_t buttonModifierCount;
+    uint64_t buttonModifierSignature;   /// See `MFButtonModifierStack`
+} MFSharedStatus;
+
+#pragma mark - Setup
+
+void MFSharedStatusLoad(void);
+
+#pragma mark - Writing (Helper)
+
+void MFSharedStatusUpdate(void (^NS_NOESCAPE update)(MFSharedStatus *status));
+
+/// Feedback
+///     Returns NO if the feedback couldn't be put into the shared ring (too large, ring full, not plist-serializable, no shared memory). Then you should send it through `MFMessagePort` instead.
+BOOL MFSharedStatusPushFeedback(NSString *message, NSObject *_Nullable payload);
+
+#pragma mark - Reading (mainApp)
+
+BOOL MFSharedStatusRead(MFSharedStatus *outStatus);
+
+#pragma mark - Region
+
+/// The seqlock and the ring operate on a region. The functions above use the shared one, the ones below take any region.
+///     This is so the tests can hammer them with threads on a private region in their own heap, instead of on the shared memory that a running Helper might be using.
+
+typedef struct MFSharedStatusRegion MFSharedStatusRegion;
+
+MFSharedStatusRegion *MFSharedStatusRegionCreatePrivate(void);
+void MFSharedStatusRegionFree(MFSharedStatusRegion *region);
+
+void MFSharedStatusRegionUpdate(MFSharedStatusRegion *region, void (^NS_NOESCAPE update)(MFSharedStatus *status));
+BOOL MFSharedStatusRegionRead(MFSharedStatusRegion *region, MFSharedStatus *outStatus);
+
+BOOL MFSharedStatusRegionPush(MFSharedStatusRegion *region, NSData *entry);   /// Returns NO if the entry is too large or the ring is full
+NSData *_Nullable MFSharedStatusRegionPop(MFSharedStatusRegion *region);      /// Returns nil if the ring is empty. Only call from one thread at a time.
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,299 @@
+//
+// --------------------------------------------------------------------------
+// MFSharedStatus.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// A POSIX shared memory region that the Helper writes and the mainApp reads.
+///
+/// Why:
+///     Everything between Helper and mainApp goes through MFMessagePort, which archives an NSDictionary with NSKeyedArchiver, sends it through a mach port, and unarchives it on the other side. That's fine for commands, but it's too heavy if the mainApp wants to show live info about the Helper (e.g. which modifiers are held, how long the eventTaps take) at display rate. Each query would be a round trip that blocks until the Helper answers.
+///
+/// What's in the region:
+///     1. A status block (`MFSharedStatus`), protected by a seqlock. The Helper writes it whenever something changes. The mainApp can read a consistent copy at any time without syscalls and without blocking the Helper. (Same idea as the published stack in ButtonModifiers.m. There's more than one writer thread in the Helper, so writers take `_writerLock` - that's a process-local lock and readers never touch it.)
+///     2. A single-producer / single-consumer ring for feedback messages (addMode and keyCaptureMode feedback). The Helper writes an entry and posts a Darwin notification, and the mainApp drains the ring and hands the messages to MFMessagePort's normal message handling. Entries are binary plists, which are much smaller and faster than keyed archives. If a message doesn't fit, we fall back to MFMessagePort. (There are several producer threads in the Helper, but they take `_writerLock`, so from the ring's perspective, there's only one producer.)
+///
+/// Notes:
+///     - Both processes open the region with `O_CREAT`, so it doesn't matter who starts first. macOS only allows `ftruncate()` once per shm object, so whoever comes second just fails that call.
+///     - When the Helper (re)starts, it takes over the region: It finishes any write that a crashed Helper left hanging and drops unread ring entries.
+///     - The mainApp reads the status block in `HelperServices` to find out whether the helper is running without a message round trip.
+///     - Readers give up after a bounded number of retries, so a Helper that crashed in the middle of a write can't make the mainApp spin forever.
+///     - If the layout changes, change `kMFSharedStatusName`, so old and new versions don't misinterpret each other's memory.
+///     - The core of this (region layout, seqlock, ring) is plain C11 + POSIX, only the notification and the plist encoding are Apple-specific.
+
+#import "MFSharedStatus.h"
+#import "Constants.h"
+#import "SharedUtility.h"
+#import "Locator.h"
+#import "MFMessagePort.h"
+#import <stdatomic.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <fcntl.h>
+#import <os/lock.h>
+#import <notify.h>
+
+#pragma mark - Layout
+
+#define kMFSharedStatusName                 "/com.nuebling.mmf.status.2" /// Max 31 chars on macOS
+#define kMFSharedStatusFeedbackNotification "com.nuebling.mac-mouse-fix.status-feedback"
+#define kMFSharedStatusMagic                0x4D465353 /// 'MFSS'
+#define kMFSharedStatusRingCapacity         32 /// Needs to be a power of 2
+#define kMFSharedStatusRingEntryCapacity    (512 - sizeof(uint32_t))
+#define kMFSharedStatusMaxReadAttempts      1000
+
+typedef struct {
+    uint32_t length;
+    uint8_t bytes[kMFSharedStatusRingEntryCapacity];
+} MFSharedStatusRingEntry;
+
+struct MFSharedStatusRegion {
+    
+    uint32_t magic;
+    uint32_t size;
+    
+    struct {
+        _Atomic(uint32_t) sequence; /// Odd while a write is in progress
+        MFSharedStatus status;
+    } __attribute__((aligned(64))) published;
+    
+    _Atomic(uint64_t) ringHead __attribute__((aligned(64))); /// Only written by the producer (Helper)
+    _Atomic(uint64_t) ringTail __attribute__((aligned(64))); /// Only written by the consumer (mainApp)
+    MFSharedStatusRingEntry ring[kMFSharedStatusRingCapacity];
+    
+};
+
+static MFSharedStatusRegion *_region = NULL;
+static os_unfair_lock _writerLock = OS_UNFAIR_LOCK_INIT;
+
+static void drainFeedback(void);
+
+#pragma mark - Setup
+
+void MFSharedStatusLoad(void) {
+    
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        /// Open
+        int fd = shm_open(kMFSharedStatusName, O_RDWR | O_CREAT, 0600);
+        if (fd < 0) {
+            DDLogWarn(@"MFSharedStatus - shm_open failed with errno %d. Live status won't be available.", errno);
+            return;
+        }
+        
+        /// Size
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size == 0) {
+            ftruncate(fd, sizeof(MFSharedStatusRegion)); /// Fails if the other process already did this. That's fine.
+        }
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MFSharedStatusRegion)) {
+            DDLogWarn(@"MFSharedStatus - shared memory has unexpected size %lld. Live status won't be available.", (long long)st.st_size);
+            close(fd);
+            return;
+        }
+        
+        /// Map
+        void *memory = mmap(NULL, sizeof(MFSharedStatusRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED) {
+            DDLogWarn(@"MFSharedStatus - mmap failed with errno %d. Live status won't be available.", errno);
+            return;
+        }
+        MFSharedStatusRegion *region = memory;
+        
+#if IS_HELPER
+        
+        /// Take over region
+        
+        region->magic = kMFSharedStatusMagic;
+        region->size = sizeof(MFSharedStatusRegion);
+        
+        uint32_t sequence = atomic_load_explicit(&region->published.sequence, memory_order_relaxed);
+        if (sequence & 1) {
+            atomic_store_explicit(&region->published.sequence, sequence + 1, memory_order_release); /// Previous Helper crashed during a write
+        }
+        
+        uint64_t tail = atomic_load_explicit(&region->ringTail, memory_order_acquire);
+        atomic_store_explicit(&region->ringHead, tail, memory_order_release);
+        
+        _region = region;
+        
+        MFSharedStatusUpdate(^(MFSharedStatus *status) {
+            memset(status, 0, sizeof(*status));
+            status->helperPid = (uint32_t)getpid();
+            status->helperBundleVersion = (uint32_t)Locator.bundleVersion;
+        });
+        
+#elif IS_MAIN_APP
+        
+        _region = region;
+        
+        /// Listen for feedback
+        int token;
+        notify_register_dispatch(kMFSharedStatusFeedbackNotification, &token, dispatch_get_main_queue(), ^(int t) {
+            drainFeedback();
+        });
+        
+#endif
+    });
+}
+
+#pragma mark - Private regions
+
+MFSharedStatusRegion *MFSharedStatusRegionCreatePrivate(void) {
+    MFSharedStatusRegion *region = calloc(1, sizeof(MFSharedStatusRegion));
+    region->magic = kMFSharedStatusMagic;
+    region->size = sizeof(MFSharedStatusRegion);
+    return region;
+}
+
+void MFSharedStatusRegionFree(MFSharedStatusRegion *region) {
+    free(region);
+}
+
+#pragma mark - Status block
+
+void MFSharedStatusUpdate(void (^NS_NOESCAPE update)(MFSharedStatus *status)) {
+    MFSharedStatusRegion *region = _region;
+    if (region == NULL) return;
+    MFSharedStatusRegionUpdate(region, update);
+}
+
+BOOL MFSharedStatusRead(MFSharedStatus *outStatus) {
+    
+    /// Returns NO if there's no Helper status to read.
+    
+    MFSharedStatusRegion *region = _region;
+    if (region == NULL) return NO;
+    return MFSharedStatusRegionRead(region, outStatus);
+}
+
+void MFSharedStatusRegionUpdate(MFSharedStatusRegion *region, void (^NS_NOESCAPE update)(MFSharedStatus *status)) {
+    
+    os_unfair_lock_lock(&_writerLock);
+    
+    uint32_t sequence = atomic_load_explicit(&region->published.sequence, memory_order_relaxed);
+    atomic_store_explicit(&region->published.sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    
+    update(&region->published.status);
+    
+    atomic_store_explicit(&region->published.sequence, sequence + 2, memory_order_release);
+    
+    os_unfair_lock_unlock(&_writerLock);
+}
+
+BOOL MFSharedStatusRegionRead(MFSharedStatusRegion *region, MFSharedStatus *outStatus) {
+    
+    if (region->magic != kMFSharedStatusMagic || region->size != sizeof(MFSharedStatusRegion)) return NO;
+    
+    for (int i = 0; i < kMFSharedStatusMaxReadAttempts; i++) {
+        
+        uint32_t sequenceBefore = atomic_load_explicit(&region->published.sequence, memory_order_acquire);
+        if (sequenceBefore & 1) continue;
+        
+        *outStatus = region->published.status;
+        
+        atomic_thread_fence(memory_order_acquire);
+        uint32_t sequenceAfter = atomic_load_explicit(&region->published.sequence, memory_order_relaxed);
+        if (sequenceBefore == sequenceAfter) {
+            outStatus->activeDeviceName[kMFSharedStatusDeviceNameCapacity - 1] = '\0'; /// Don't trust the other process with our string handling
+            return outStatus->helperPid != 0;
+        }
+    }
+    
+    return NO;
+}
+
+#pragma mark - Feedback ring
+
+BOOL MFSharedStatusPushFeedback(NSString *message, NSObject *_Nullable payload) {
+    
+    MFSharedStatusRegion *region = _region;
+    if (region == NULL) return NO;
+    
+    /// Encode
+    NSDictionary *messageDict = payload != nil ? @{ kMFMessageKeyMessage: message, kMFMessageKeyPayload: payload } : @{ kMFMessageKeyMessage: message };
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:messageDict format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+    if (data == nil) return NO;
+    
+    /// Write entry
+    if (!MFSharedStatusRegionPush(region, data)) return NO;
+    
+    /// Wake up consumer
+    notify_post(kMFSharedStatusFeedbackNotification);
+    
+    DDLogInfo(@"Sent message: %@ with payload: %@ via shared memory", message, payload);
+    
+    return YES;
+}
+
+static void drainFeedback(void) {
+    
+    /// Only call on the main queue (single consumer)
+    
+    MFSharedStatusRegion *region = _region;
+    if (region == NULL) return;
+    
+    NSData *data;
+    while ((data = MFSharedStatusRegionPop(region)) != nil) {
+        
+        /// Decode & handle
+        NSDictionary *messageDict = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:nil error:nil];
+        NSString *message = [messageDict isKindOfClass:[NSDictionary class]] ? messageDict[kMFMessageKeyMessage] : nil;
+        if (![message isKindOfClass:[NSString class]]) {
+            DDLogWarn(@"MFSharedStatus - dropping undecodable feedback entry");
+            continue;
+        }
+        [MFMessagePort handleMessage:message withPayload:messageDict[kMFMessageKeyPayload]];
+    }
+}
+
+BOOL MFSharedStatusRegionPush(MFSharedStatusRegion *region, NSData *entryData) {
+    
+    if (entryData.length > kMFSharedStatusRingEntryCapacity) return NO;
+    
+    os_unfair_lock_lock(&_writerLock);
+    
+    uint64_t head = atomic_load_explicit(&region->ringHead, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&region->ringTail, memory_order_acquire);
+    if (head - tail >= kMFSharedStatusRingCapacity) {
+        os_unfair_lock_unlock(&_writerLock);
+        return NO;
+    }
+    
+    MFSharedStatusRingEntry *entry = &region->ring[head & (kMFSharedStatusRingCapacity - 1)];
+    entry->length = (uint32_t)entryData.length;
+    memcpy(entry->bytes, entryData.bytes, entryData.length);
+    atomic_store_explicit(&region->ringHead, head + 1, memory_order_release);
+    
+    os_unfair_lock_unlock(&_writerLock);
+    
+    return YES;
+}
+
+NSData *MFSharedStatusRegionPop(MFSharedStatusRegion *region) {
+    
+    uint64_t tail = atomic_load_explicit(&region->ringTail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&region->ringHead, memory_order_acquire);
+    
+    if (head - tail > kMFSharedStatusRingCapacity) { /// Helper restarted and reset the ring
+        atomic_store_explicit(&region->ringTail, head, memory_order_release);
+        return nil;
+    }
+    if (tail == head) return nil;
+    
+    /// Copy entry
+    MFSharedStatusRingEntry *entry = &region->ring[tail & (kMFSharedStatusRingCapacity - 1)];
+    uint32_t length = MIN(entry->length, (uint32_t)kMFSharedStatusRingEntryCapacity);
+    NSData *data = [NSData dataWithBytes:entry->bytes length:length];
+    
+    /// Free entry
+    atomic_store_explicit(&region->ringTail, tail + 1, memory_order_release);
+    
+    return data;
+}
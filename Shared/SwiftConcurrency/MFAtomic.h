@@ -0,0 +1,30 @@
+//
+// --------------------------------------------------------------------------
+// MFAtomic.h
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Thin wrappers around C11 atomics, so we can use them from Swift.
+///
+/// Notes:
+/// - Swift can't use `<stdatomic.h>` directly, and the `@Atomic` property wrapper in Concurrency.swift takes a lock on every access. That's fine most of the time, but not for stuff that's called on every input event.
+/// - Pass a pointer that stays valid and doesn't move, e.g. from `UnsafeMutablePointer<Int32>.allocate(capacity: 1)`. Don't pass `&someSwiftProperty` - Swift might hand you a pointer to a temporary copy.
+
+#ifndef MFAtomic_h
+#define MFAtomic_h
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+static inline int32_t MFAtomicLoadRelaxed(int32_t *pointer) {
+    return atomic_load_explicit((_Atomic(int32_t) *)pointer, memory_order_relaxed);
+}
+
+static inline void MFAtomicStoreRelaxed(int32_t *pointer, int32_t value) {
+    atomic_store_explicit((_Atomic(int32_t) *)pointer, value, memory_order_relaxed);
+}
+
+#endif /* MFAtomic_h */
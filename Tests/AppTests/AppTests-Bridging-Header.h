@@ -0,0 +1,17 @@
+//
+// --------------------------------------------------------------------------
+// AppTests-Bridging-Header.h
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// The tests run inside the mainApp (See TEST_HOST), and `@testable import Mac_Mouse_Fix` gives them the app's Swift code. But the C and ObjC declarations that the app's Swift code uses come from the app's bridging header, which isn't part of the module. So we import it here, too.
+
+#ifndef AppTests_Bridging_Header_h
+#define AppTests_Bridging_Header_h
+
+#import "Mac Mouse Fix-Bridging-Header.h"
+
+#endif /* AppTests_Bridging_Header_h */
@@ -0,0 +1,124 @@
+//
+// --------------------------------------------------------------------------
+// BezierEpsilonCalibrationTests.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Checks that `Bezier.coarsestEpsilon(resolution:tolerance:)` keeps its promise on random curves: Evaluating with the calibrated epsilon is never off by more than `tolerance` from a reference evaluation.
+
+import XCTest
+@testable import Mac_Mouse_Fix
+
+final class BezierEpsilonCalibrationTests: XCTestCase {
+
+    /// Deterministic so failures are reproducible
+    private struct SplitMix64: RandomNumberGenerator {
+        var state: UInt64
+        mutating func next() -> UInt64 {
+            state &+= 0x9E3779B97F4A7C15
+            var z = state
+            z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+            z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+            return z ^ (z >> 31)
+        }
+    }
+
+    private func randomAnimationCurve(_ rng: inout SplitMix64) -> Bezier {
+
+        /// Cubic from (0,0) to (1,1) with the inner control points in the unit square. Sorting the x values keeps x(t) monotonic, like for all our animation curves.
+
+        var xs = [Double.random(in: 0...1, using: &rng), Double.random(in: 0...1, using: &rng)]
+        xs.sort()
+        let ys = [Double.random(in: 0...1, using: &rng), Double.random(in: 0...1, using: &rng)]
+        return Bezier(controlPoints: [_P(0, 0), _P(xs[0], ys[0]), _P(xs[1], ys[1]), _P(1, 1)], defaultEpsilon: Bezier.maxCalibratedEpsilon)
+    }
+
+    func testCalibratedEpsilonStaysWithinTolerance() {
+
+        var rng = SplitMix64(state: 0x5EED)
+        let resolution = 200
+        let tolerances = [1e-3, 1e-4, 1e-5]
+
+        for _ in 0..<50 {
+            let curve = randomAnimationCurve(&rng)
+            for tolerance in tolerances {
+
+                let epsilon = curve.coarsestEpsilon(resolution: resolution, tolerance: tolerance)
+
+                XCTAssertLessThanOrEqual(epsilon, Bezier.maxCalibratedEpsilon)
+                XCTAssertGreaterThanOrEqual(epsilon, Bezier.minCalibratedEpsilon)
+
+                /// minCalibratedEpsilon is returned when even that isn't good enough. There's nothing to guarantee in that case.
+                if epsilon > Bezier.minCalibratedEpsilon {
+                    let error = curve.maxError(resolution: resolution, epsilon: epsilon)
+                    XCTAssertLessThanOrEqual(error, tolerance, "controlPoints: \(curve.controlPoints)")
+                }
+            }
+        }
+    }
+
+    func testTighterToleranceNeverGivesCoarserEpsilon() {
+
+        var rng = SplitMix64(state: 0xC0FFEE)
+
+        for _ in 0..<20 {
+            let curve = randomAnimationCurve(&rng)
+            let loose = curve.coarsestEpsilon(resolution: 200, tolerance: 1e-3)
+            let tight = curve.coarsestEpsilon(resolution: 200, tolerance: 1e-6)
+            XCTAssertLessThanOrEqual(tight, loose * 2.0, "controlPoints: \(curve.controlPoints)") /// Factor 2 because the search isn't exact
+        }
+    }
+
+    func testCalibrationCanPickACoarserEpsilonThanBefore() {
+
+        /// For a tolerance that's loose compared to 0.001 (the epsilon we used to pick by hand), the search should be able to go coarser than that.
+
+        let curve = Bezier(controlPoints: [_P(0, 0), _P(0, 0), _P(0.5, 1), _P(1, 1)], defaultEpsilon: 0.001)
+        let epsilon = curve.coarsestEpsilon(resolution: 200, tolerance: 1e-2)
+        XCTAssertGreaterThan(epsilon, 0.001)
+        XCTAssertLessThanOrEqual(curve.maxError(resolution: 200, epsilon: epsilon), 1e-2)
+    }
+
+    func testCalibrationUsesCacheOnSecondCurve() {
+
+        /// The first curve kicks off calibration in the background, later curves with the same shape pick up the result.
+
+        let points = [_P(0, 0), _P(0, 0), _P(0.5, 1), _P(1, 1)]
+        let resolution = 123 /// Unusual resolution so other tests don't fill the cache first
+        let tolerance = 1e-4
+
+        let first = Bezier(controlPoints: points, defaultEpsilon: 0.001).calibrateEpsilon(forResolution: resolution, tolerance: tolerance)
+        XCTAssertFalse(first.epsilonIsCalibrated)
+        XCTAssertEqual(first.defaultEpsilon, 0.001)
+
+        let expected = Bezier(controlPoints: points, defaultEpsilon: 0.001).coarsestEpsilon(resolution: resolution, tolerance: tolerance)
+
+        let deadline = Date(timeIntervalSinceNow: 10)
+        var later: Bezier
+        repeat {
+            later = Bezier(controlPoints: points, defaultEpsilon: 0.001).calibrateEpsilon(forResolution: resolution, tolerance: tolerance)
+            if later.epsilonIsCalibrated { break }
+            Thread.sleep(forTimeInterval: 0.01)
+        } while Date() < deadline
+
+        XCTAssertTrue(later.epsilonIsCalibrated) /// Came from the cache
+        XCTAssertEqual(later.defaultEpsilon, expected)
+    }
+
+    func testCalibrateNowFillsCache() {
+
+        let points = [_P(0, 0), _P(0.2, 0.7), _P(0.6, 1), _P(1, 1)]
+        let resolution = 321
+        let tolerance = 1e-4
+
+        let first = Bezier(controlPoints: points, defaultEpsilon: 0.001).calibrateEpsilonNow(forResolution: resolution, tolerance: tolerance)
+        XCTAssertTrue(first.epsilonIsCalibrated)
+
+        let second = Bezier(controlPoints: points, defaultEpsilon: 0.001).calibrateEpsilon(forResolution: resolution, tolerance: tolerance)
+        XCTAssertTrue(second.epsilonIsCalibrated) /// No need to wait, calibrateEpsilonNow() already stored the result
+        XCTAssertEqual(second.defaultEpsilon, first.defaultEpsilon)
+    }
+}
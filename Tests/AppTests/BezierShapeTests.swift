@@ -0,0 +1,111 @@
+//
+// --------------------------------------------------------------------------
+// BezierShapeTests.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Tests and benchmarks for the shape interning in BezierShape.swift
+///     The benchmarks compare creating and evaluating curves the way ScrollConfig does (same shape over and over, interned) and the way Scroll.m's speedSmoothing does (new shape on every tick, not interned).
+
+import XCTest
+@testable import Mac_Mouse_Fix
+
+final class BezierShapeTests: XCTestCase {
+
+    private let easeOut = [_P(0, 0), _P(0, 0), _P(0.5, 1), _P(1, 1)]
+
+    private func speedSmoothingPoints(_ i: Int) -> [P] {
+        /// Like Scroll.m's speedSmoothing baseCurve. P1 depends on the current speed, so it's different on every tick.
+        let p1 = 0.1 + 0.8 * Double(i % 997) / 997.0
+        return [_P(0, 0), _P(0.15, p1), _P(1, 1)]
+    }
+
+    func testSameControlPointsShareShape() {
+        let a = Bezier(controlPoints: easeOut, defaultEpsilon: 0.001)
+        let b = Bezier(controlPoints: easeOut, defaultEpsilon: 0.08)
+        XCTAssertTrue(a.shape === b.shape)
+    }
+
+    func testUninternedCurvesDontShareShapeButEvaluateTheSame() {
+
+        let interned = Bezier(controlPoints: easeOut, defaultEpsilon: 1e-9)
+        let uninterned = Bezier(controlPoints: easeOut, defaultEpsilon: 1e-9, intern: false)
+        XCTAssertFalse(interned.shape === uninterned.shape)
+        XCTAssertNil(uninterned.shape?.initialGuessForT(x: 0.5)) /// No inverse table
+
+        for i in 0...100 {
+            let x = Double(i) / 100.0
+            XCTAssertEqual(interned.evaluate(at: x), uninterned.evaluate(at: x), accuracy: 1e-6)
+        }
+    }
+
+    func testInternTableIsPruned() {
+
+        /// Many one-off shapes that are interned anyway. Their keys shouldn't pile up.
+
+        for i in 0..<(20 * BezierShape.internTablePruneInterval) {
+            autoreleasepool {
+                _ = Bezier(controlPoints: speedSmoothingPoints(i), defaultEpsilon: 0.01)
+            }
+        }
+        XCTAssertLessThanOrEqual(BezierShape.nOfInternTableEntries, 2 * BezierShape.internTablePruneInterval)
+    }
+
+    func testUninternedCurvesDontTouchInternTable() {
+
+        let before = BezierShape.nOfInternTableEntries
+        for i in 0..<1000 {
+            _ = Bezier(controlPoints: speedSmoothingPoints(i), defaultEpsilon: 0.01, intern: false)
+        }
+        XCTAssertEqual(BezierShape.nOfInternTableEntries, before)
+    }
+
+    // MARK: Benchmarks
+
+    func testPerformanceOfReusedShape() {
+
+        /// ScrollConfig-style: The same shape is created over and over and evaluated a few times, like an animation frame would.
+
+        let keepAlive = Bezier(controlPoints: easeOut, defaultEpsilon: 0.001) /// So the shape stays interned between iterations
+        measure {
+            var sum = 0.0
+            for i in 0..<10_000 {
+                let curve = Bezier(controlPoints: easeOut, defaultEpsilon: 0.001)
+                sum += curve.evaluate(at: Double(i % 100) / 100.0)
+            }
+            XCTAssertGreaterThan(sum, 0)
+        }
+        _ = keepAlive
+    }
+
+    func testPerformanceOfOneOffShapesInterned() {
+
+        /// Scroll.m-style speedSmoothing curves, if they were interned. Every creation is a miss.
+
+        measure {
+            var sum = 0.0
+            for i in 0..<10_000 {
+                let curve = Bezier(controlPoints: speedSmoothingPoints(i), defaultEpsilon: 0.01)
+                sum += curve.evaluate(at: 0.5)
+            }
+            XCTAssertGreaterThan(sum, 0)
+        }
+    }
+
+    func testPerformanceOfOneOffShapesUninterned() {
+
+        /// Same as above with `intern: false`, which is what Scroll.m does. Should be faster than the interned version.
+
+        measure {
+            var sum = 0.0
+            for i in 0..<10_000 {
+                let curve = Bezier(controlPoints: speedSmoothingPoints(i), defaultEpsilon: 0.01, intern: false)
+                sum += curve.evaluate(at: 0.5)
+            }
+            XCTAssertGreaterThan(sum, 0)
+        }
+    }
+}
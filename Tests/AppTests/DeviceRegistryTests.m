@@ -0,0 +1,181 @@
+//
+// --------------------------------------------------------------------------
+// DeviceRegistryTests.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Simulated hot-plug storms for DeviceRegistry.m
+///     After every attach and detach, the incrementally updated counters are compared against values recomputed from scratch over the attached devices. That's how DeviceManager used to compute them.
+///     DeviceRegistry.m is a Helper source, but it's plain C, so it's compiled straight into the test target.
+
+#import <XCTest/XCTest.h>
+#import "DeviceRegistry.h"
+
+@interface DeviceRegistryTests : XCTestCase
+
+@end
+
+@implementation DeviceRegistryTests
+
+#pragma mark - Helper
+
+static MFDeviceCapabilities capabilities(int nOfButtons) {
+    return (MFDeviceCapabilities){ .hasScrollWheel = nOfButtons % 2 == 0, .hasPointing = nOfButtons % 3 != 0, .nOfButtons = nOfButtons };
+}
+
+- (void)assertCountersMatchSlots:(const MFDeviceRegistry *)registry {
+
+    /// Recompute everything by iterating over the used slots
+
+    int nOfDevices = 0, nWithScrollWheel = 0, nWithPointing = 0, nWithUsableButtons = 0, maxButtonNumber = 0;
+
+    for (int i = 0; i < kMFDeviceRegistryCapacity; i++) {
+        if ((registry->usedSlots & (1u << i)) == 0) continue;
+        MFDeviceCapabilities c = registry->capabilities[i];
+        nOfDevices += 1;
+        if (c.hasScrollWheel) nWithScrollWheel += 1;
+        if (c.hasPointing) nWithPointing += 1;
+        if (c.nOfButtons > 2) nWithUsableButtons += 1;
+        int b = MIN(MAX(c.nOfButtons, 0), kMFDeviceRegistryMaxButtonNumber);
+        maxButtonNumber = MAX(maxButtonNumber, b);
+    }
+
+    XCTAssertEqual(registry->nOfDevices, nOfDevices);
+    XCTAssertEqual(registry->nWithScrollWheel, nWithScrollWheel);
+    XCTAssertEqual(registry->nWithPointing, nWithPointing);
+    XCTAssertEqual(registry->nWithUsableButtons, nWithUsableButtons);
+    XCTAssertEqual(MFDeviceRegistryMaxButtonNumber(registry), maxButtonNumber);
+    XCTAssertEqual(MFDeviceRegistryHasDevices(registry), nOfDevices > 0);
+}
+
+#pragma mark - Tests
+
+- (void)testHotPlugStorm {
+
+    /// Random attach / detach churn. Devices come back with the same uniqueID sometimes, like a flaky USB connection would.
+
+    MFDeviceRegistry registry = {0};
+    uint64_t attachedIDs[kMFDeviceRegistryCapacity] = {0}; /// What we expect at each index
+
+    srand48(74);
+
+    for (int i = 0; i < 100000; i++) {
+
+        if (drand48() < 0.55) {
+
+            /// Attach
+            uint64_t uniqueID = 1 + (uint64_t)(drand48() * 48);
+            int nOfButtons = (int)(drand48() * 12);
+
+            bool isAttached = MFDeviceRegistryIndexOfUniqueID(&registry, uniqueID) != kMFDeviceIndexNone;
+            bool isFull = registry.usedSlots == UINT32_MAX;
+            int expectedIndex = isFull ? kMFDeviceIndexNone : __builtin_ctz(~registry.usedSlots);
+
+            int index = MFDeviceRegistryAdd(&registry, uniqueID, capabilities(nOfButtons));
+
+            if (isAttached || isFull) {
+                XCTAssertEqual(index, kMFDeviceIndexNone);
+            } else {
+                XCTAssertEqual(index, expectedIndex); /// Lowest free slot
+                attachedIDs[index] = uniqueID;
+            }
+
+        } else {
+
+            /// Detach a random index, which might be empty
+            int index = (int)(drand48() * kMFDeviceRegistryCapacity);
+            bool wasUsed = attachedIDs[index] != 0;
+
+            XCTAssertEqual(MFDeviceRegistryRemove(&registry, index), wasUsed);
+            attachedIDs[index] = 0;
+        }
+
+        /// Check lookups
+        for (int j = 0; j < kMFDeviceRegistryCapacity; j++) {
+            if (attachedIDs[j] != 0) {
+                XCTAssertEqual(MFDeviceRegistryIndexOfUniqueID(&registry, attachedIDs[j]), j);
+            }
+        }
+
+        [self assertCountersMatchSlots:&registry];
+
+        if (self.testRun.failureCount > 0) break; /// Don't print 100k failures
+    }
+}
+
+- (void)testIndexesAreReusedAfterFillingAllSlots {
+
+    MFDeviceRegistry registry = {0};
+
+    /// Fill all slots
+    for (int i = 0; i < kMFDeviceRegistryCapacity; i++) {
+        XCTAssertEqual(MFDeviceRegistryAdd(&registry, 100 + i, capabilities(5)), i);
+    }
+    XCTAssertEqual(registry.usedSlots, UINT32_MAX);
+    XCTAssertEqual(MFDeviceRegistryAdd(&registry, 999, capabilities(5)), kMFDeviceIndexNone);
+
+    /// Free a few slots in the middle and at the end, then attach new devices. They get the lowest free indexes.
+    XCTAssertTrue(MFDeviceRegistryRemove(&registry, 31));
+    XCTAssertTrue(MFDeviceRegistryRemove(&registry, 7));
+    XCTAssertTrue(MFDeviceRegistryRemove(&registry, 20));
+    XCTAssertFalse(MFDeviceRegistryRemove(&registry, 20));
+
+    XCTAssertEqual(MFDeviceRegistryAdd(&registry, 1000, capabilities(5)), 7);
+    XCTAssertEqual(MFDeviceRegistryAdd(&registry, 1001, capabilities(5)), 20);
+    XCTAssertEqual(MFDeviceRegistryAdd(&registry, 1002, capabilities(5)), 31);
+    XCTAssertEqual(MFDeviceRegistryAdd(&registry, 1003, capabilities(5)), kMFDeviceIndexNone);
+
+    /// Removed devices can't be found anymore, new ones can
+    XCTAssertEqual(MFDeviceRegistryIndexOfUniqueID(&registry, 100 + 7), kMFDeviceIndexNone);
+    XCTAssertEqual(MFDeviceRegistryIndexOfUniqueID(&registry, 1001), 20);
+
+    /// Empty it completely and fill it again
+    for (int i = 0; i < kMFDeviceRegistryCapacity; i++) {
+        XCTAssertTrue(MFDeviceRegistryRemove(&registry, i));
+    }
+    XCTAssertEqual(registry.usedSlots, 0u);
+    [self assertCountersMatchSlots:&registry];
+
+    for (int i = 0; i < kMFDeviceRegistryCapacity; i++) {
+        XCTAssertEqual(MFDeviceRegistryAdd(&registry, 2000 + i, capabilities(i)), i);
+    }
+    [self assertCountersMatchSlots:&registry];
+}
+
+- (void)testMaxButtonNumberAfterRemovals {
+
+    MFDeviceRegistry registry = {0};
+
+    int a = MFDeviceRegistryAdd(&registry, 1, capabilities(5));
+    int b = MFDeviceRegistryAdd(&registry, 2, capabilities(8));
+    int c = MFDeviceRegistryAdd(&registry, 3, capabilities(8));
+    int d = MFDeviceRegistryAdd(&registry, 4, capabilities(3));
+    XCTAssertEqual(MFDeviceRegistryMaxButtonNumber(&registry), 8);
+
+    /// One of two devices with the max removed -> max stays
+    MFDeviceRegistryRemove(&registry, b);
+    XCTAssertEqual(MFDeviceRegistryMaxButtonNumber(&registry), 8);
+
+    /// Last one with the max removed -> falls back to the next-highest
+    MFDeviceRegistryRemove(&registry, c);
+    XCTAssertEqual(MFDeviceRegistryMaxButtonNumber(&registry), 5);
+
+    MFDeviceRegistryRemove(&registry, a);
+    XCTAssertEqual(MFDeviceRegistryMaxButtonNumber(&registry), 3);
+
+    MFDeviceRegistryRemove(&registry, d);
+    XCTAssertEqual(MFDeviceRegistryMaxButtonNumber(&registry), 0);
+    XCTAssertFalse(MFDeviceRegistryHasUsableButtons(&registry));
+
+    /// Button counts above the histogram size are clamped, and removing them still clears the bit
+    int e = MFDeviceRegistryAdd(&registry, 5, capabilities(500));
+    XCTAssertEqual(MFDeviceRegistryMaxButtonNumber(&registry), kMFDeviceRegistryMaxButtonNumber);
+    MFDeviceRegistryRemove(&registry, e);
+    XCTAssertEqual(MFDeviceRegistryMaxButtonNumber(&registry), 0);
+    XCTAssertEqual(registry.buttonNumbers, 0ull);
+}
+
+@end
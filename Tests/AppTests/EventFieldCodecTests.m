@@ -0,0 +1,151 @@
+//
+// --------------------------------------------------------------------------
+// EventFieldCodecTests.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Round trips between the records in EventFieldCodec.h and real CGEvents.
+///     The expected values are read field-by-field with the plain CGEvent getters, straight from the field tables. So these tests check the codec's descriptor loop against the tables, not against itself.
+///     The records are filled with random values from a fixed seed. The ranges are the ones our events actually use, since CGEvent doesn't store arbitrary values for every field (e.g. field 55 is the event type).
+
+#import <XCTest/XCTest.h>
+#import "EventFieldCodec.h"
+
+@interface EventFieldCodecTests : XCTestCase
+
+@end
+
+@implementation EventFieldCodecTests
+
+#pragma mark - Helper
+
+static int64_t readInt(CGEventRef event, int64_t field) { return CGEventGetIntegerValueField(event, (CGEventField)field); }
+static double readDouble(CGEventRef event, int64_t field) { return CGEventGetDoubleValueField(event, (CGEventField)field); }
+
+static int64_t randomInt(int64_t min, int64_t max) {
+    return min + (int64_t)(drand48() * (double)(max - min + 1));
+}
+static int64_t randomPhase(void) {
+    static const int64_t phases[] = { 0, 1, 2, 4, 8, 128 }; /// IOHIDEventPhaseBits and 0
+    return phases[randomInt(0, 5)];
+}
+static double randomGestureDelta(void) {
+    return (double)randomInt(-256 * 50, 256 * 50) / 256.0; /// Exactly representable even if CGEvent stores it as a float
+}
+
+#pragma mark - Tests
+
+- (void)testScrollEventRecordRoundTrip {
+
+    srand48(73);
+
+    for (int i = 0; i < 2000; i++) {
+
+        MFScrollEventRecord record = {
+            .type = 22,
+            .isContinuous = randomInt(0, 1),
+            .invertedFromDevice = randomInt(0, 1),
+            .deltaAxis1 = randomInt(-100, 100),
+            .pointDeltaAxis1 = randomInt(-2000, 2000),
+            .fixedPtDeltaAxis1 = randomInt(-100 << 16, 100 << 16),
+            .deltaAxis2 = randomInt(-100, 100),
+            .pointDeltaAxis2 = randomInt(-2000, 2000),
+            .fixedPtDeltaAxis2 = randomInt(-100 << 16, 100 << 16),
+            .scrollPhase = randomPhase(),
+            .momentumPhase = randomInt(0, 3),
+        };
+
+        CGEventRef event = CGEventCreate(NULL);
+        MFScrollEventRecordEncode(&record, event);
+
+        #define CHECK_FIELD(member, field, kind) XCTAssertEqual(read##kind(event, field), record.member, @"%s (iteration %d)", #member, i);
+        MF_SCROLL_EVENT_FIELDS(CHECK_FIELD)
+        #undef CHECK_FIELD
+
+        XCTAssertEqual(CGEventGetType(event), kCGEventScrollWheel);
+
+        CFRelease(event);
+    }
+}
+
+- (void)testGestureScrollEventRecordRoundTrip {
+
+    srand48(74);
+
+    for (int i = 0; i < 2000; i++) {
+
+        MFGestureScrollEventRecord record = {
+            .type = 29,
+            .subtype = 6,
+            .deltaX = randomGestureDelta(),
+            .deltaY = randomGestureDelta(),
+            .phase = randomPhase(),
+        };
+
+        CGEventRef event = CGEventCreate(NULL);
+        MFGestureScrollEventRecordEncode(&record, event);
+
+        #define CHECK_FIELD(member, field, kind) XCTAssertEqual(read##kind(event, field), record.member, @"%s (iteration %d)", #member, i);
+        MF_GESTURE_SCROLL_EVENT_FIELDS(CHECK_FIELD)
+        #undef CHECK_FIELD
+
+        CFRelease(event);
+    }
+}
+
+- (void)testScrollInputRecordDecode {
+
+    /// Decode what the scroll eventTap would see
+
+    srand48(75);
+
+    for (int i = 0; i < 2000; i++) {
+
+        CGEventRef event = CGEventCreateScrollWheelEvent(NULL, kCGScrollEventUnitLine, 2, (int32_t)randomInt(-10, 10), (int32_t)randomInt(-10, 10));
+        CGEventSetIntegerValueField(event, kCGScrollWheelEventIsContinuous, randomInt(0, 1));
+        CGEventSetIntegerValueField(event, kCGScrollWheelEventScrollPhase, randomPhase());
+        CGEventSetIntegerValueField(event, kCGScrollWheelEventPointDeltaAxis1, randomInt(-2000, 2000));
+        CGEventSetIntegerValueField(event, kCGScrollWheelEventPointDeltaAxis2, randomInt(-2000, 2000));
+
+        MFScrollInputRecord record;
+        MFScrollInputRecordDecode(event, &record);
+
+        #define CHECK_FIELD(member, field, kind) XCTAssertEqual(record.member, read##kind(event, field), @"%s (iteration %d)", #member, i);
+        MF_SCROLL_INPUT_FIELDS(CHECK_FIELD)
+        #undef CHECK_FIELD
+
+        CFRelease(event);
+    }
+}
+
+- (void)testTablesDontMapTwoMembersToOneField {
+
+    /// If two members had the same field, encoding would silently overwrite one with the other.
+
+    #define COLLECT_FIELD(member, field, kind) (int64_t)(field),
+
+    int64_t scrollInput[] = { MF_SCROLL_INPUT_FIELDS(COLLECT_FIELD) };
+    int64_t scrollEvent[] = { MF_SCROLL_EVENT_FIELDS(COLLECT_FIELD) };
+    int64_t gestureScrollEvent[] = { MF_GESTURE_SCROLL_EVENT_FIELDS(COLLECT_FIELD) };
+
+    #undef COLLECT_FIELD
+
+    struct { const char *name; int64_t *fields; size_t count; } tables[] = {
+        { "scrollInput", scrollInput, sizeof(scrollInput) / sizeof(int64_t) },
+        { "scrollEvent", scrollEvent, sizeof(scrollEvent) / sizeof(int64_t) },
+        { "gestureScrollEvent", gestureScrollEvent, sizeof(gestureScrollEvent) / sizeof(int64_t) },
+    };
+
+    for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); t++) {
+        for (size_t i = 0; i < tables[t].count; i++) {
+            for (size_t j = i + 1; j < tables[t].count; j++) {
+                XCTAssertNotEqual(tables[t].fields[i], tables[t].fields[j], @"%s", tables[t].name);
+            }
+        }
+    }
+}
+
+@end
@@ -0,0 +1,137 @@
+//
+// --------------------------------------------------------------------------
+// LaunchctlParserTests.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Runs LaunchctlParser on `launchctl list <label>` outputs.
+///     The outputs follow what launchctl prints (tab indentation, unquoted values for numbers, booleans and mach ports). The paths and pids are made up.
+
+#import <XCTest/XCTest.h>
+#import "LaunchctlParser.h"
+
+@interface LaunchctlParserTests : XCTestCase
+
+@end
+
+@implementation LaunchctlParserTests
+
+#pragma mark - Captured outputs
+
+/// `launchctl list mouse.fix.helper` with the helper running (pre-Ventura, registered via launchd plist)
+static NSString *const kHelperRunning =
+@"{\n"
+@"\t\"LimitLoadToSessionType\" = \"Aqua\";\n"
+@"\t\"Label\" = \"mouse.fix.helper\";\n"
+@"\t\"OnDemand\" = false;\n"
+@"\t\"LastExitStatus\" = 0;\n"
+@"\t\"PID\" = 709;\n"
+@"\t\"Program\" = \"/Applications/Mac Mouse Fix.app/Contents/Library/LoginItems/Mac Mouse Fix Helper.app/Contents/MacOS/Mac Mouse Fix Helper\";\n"
+@"\t\"ProgramArguments\" = (\n"
+@"\t\t\"/Applications/Mac Mouse Fix.app/Contents/Library/LoginItems/Mac Mouse Fix Helper.app/Contents/MacOS/Mac Mouse Fix Helper\";\n"
+@"\t);\n"
+@"\t\"PerJobMachServices\" = {\n"
+@"\t\t\"com.apple.tsm.portname\" = mach-port-object;\n"
+@"\t\t\"com.apple.axserver\" = mach-port-object;\n"
+@"\t};\n"
+@"};\n";
+
+/// Same, after the helper quit with an error. launchd keeps the job but there's no PID.
+static NSString *const kHelperExited =
+@"{\n"
+@"\t\"LimitLoadToSessionType\" = \"Aqua\";\n"
+@"\t\"Label\" = \"mouse.fix.helper\";\n"
+@"\t\"OnDemand\" = false;\n"
+@"\t\"LastExitStatus\" = 19968;\n"
+@"\t\"Program\" = \"/Users/user/Downloads/Mac Mouse Fix.app/Contents/Library/LoginItems/Mac Mouse Fix Helper.app/Contents/MacOS/Mac Mouse Fix Helper\";\n"
+@"\t\"ProgramArguments\" = (\n"
+@"\t\t\"/Users/user/Downloads/Mac Mouse Fix.app/Contents/Library/LoginItems/Mac Mouse Fix Helper.app/Contents/MacOS/Mac Mouse Fix Helper\";\n"
+@"\t);\n"
+@"};\n";
+
+/// Finder, for a job with several program arguments and Mach services
+static NSString *const kFinder =
+@"{\n"
+@"\t\"LimitLoadToSessionType\" = \"Aqua\";\n"
+@"\t\"MachServices\" = {\n"
+@"\t\t\"com.apple.finder.ServiceProvider\" = mach-port-object;\n"
+@"\t\t\"com.apple.coreservices.quarantine-resolver\" = mach-port-object;\n"
+@"\t};\n"
+@"\t\"Label\" = \"com.apple.Finder\";\n"
+@"\t\"OnDemand\" = false;\n"
+@"\t\"LastExitStatus\" = 0;\n"
+@"\t\"PID\" = 517;\n"
+@"\t\"Program\" = \"/System/Library/CoreServices/Finder.app/Contents/MacOS/Finder\";\n"
+@"\t\"ProgramArguments\" = (\n"
+@"\t\t\"/System/Library/CoreServices/Finder.app/Contents/MacOS/Finder\";\n"
+@"\t\t\"-psn_0_0\";\n"
+@"\t);\n"
+@"};\n";
+
+/// Helper not registered
+static NSString *const kNotFound = @"Could not find service \"mouse.fix.helper\" in domain for port\n";
+
+#pragma mark - Tests
+
+- (void)testRunningHelper {
+
+    NSDictionary *info = [LaunchctlParser parseOutput:kHelperRunning];
+
+    XCTAssertEqualObjects(info[@"Label"], @"mouse.fix.helper");
+    XCTAssertEqualObjects(info[@"LastExitStatus"], @"0");
+    XCTAssertEqualObjects(info[@"PID"], @"709");
+    XCTAssertEqualObjects(info[@"OnDemand"], @"false");
+    XCTAssertEqualObjects(info[@"Program"], @"/Applications/Mac Mouse Fix.app/Contents/Library/LoginItems/Mac Mouse Fix Helper.app/Contents/MacOS/Mac Mouse Fix Helper");
+    XCTAssertEqualObjects(info[@"ProgramArguments"], @[info[@"Program"]]);
+    XCTAssertEqualObjects(info[@"PerJobMachServices"], (@{ @"com.apple.tsm.portname": @"mach-port-object", @"com.apple.axserver": @"mach-port-object" }));
+    XCTAssertEqual(info.count, 8);
+}
+
+- (void)testExitedHelper {
+
+    NSDictionary *info = [LaunchctlParser parseOutput:kHelperExited];
+
+    XCTAssertEqualObjects(info[@"Label"], @"mouse.fix.helper");
+    XCTAssertEqualObjects(info[@"LastExitStatus"], @"19968");
+    XCTAssertNil(info[@"PID"]);
+    XCTAssertEqualObjects(info[@"Program"], @"/Users/user/Downloads/Mac Mouse Fix.app/Contents/Library/LoginItems/Mac Mouse Fix Helper.app/Contents/MacOS/Mac Mouse Fix Helper");
+}
+
+- (void)testSeveralArgumentsAndNestedDict {
+
+    NSDictionary *info = [LaunchctlParser parseOutput:kFinder];
+
+    XCTAssertEqualObjects(info[@"Label"], @"com.apple.Finder");
+    XCTAssertEqualObjects(info[@"ProgramArguments"], (@[ @"/System/Library/CoreServices/Finder.app/Contents/MacOS/Finder", @"-psn_0_0" ]));
+    XCTAssertEqual([info[@"MachServices"] count], 2);
+    XCTAssertEqualObjects(info[@"PID"], @"517"); /// Keys after a nested container still land in the outer dict
+}
+
+- (void)testServiceNotFound {
+    XCTAssertNil([LaunchctlParser parseOutput:kNotFound]);
+    XCTAssertNil([LaunchctlParser parseOutput:@""]);
+}
+
+- (void)testTruncatedOutput {
+
+    /// E.g. if launchctl was killed while writing. We get what was there before the cut.
+
+    NSString *truncated = [kHelperRunning substringToIndex:[kHelperRunning rangeOfString:@"\t\t\"com.apple.axserver\""].location];
+    NSDictionary *info = [LaunchctlParser parseOutput:truncated];
+
+    XCTAssertEqualObjects(info[@"Label"], @"mouse.fix.helper");
+    XCTAssertEqualObjects(info[@"PID"], @"709");
+    XCTAssertEqualObjects(info[@"ProgramArguments"], @[info[@"Program"]]);
+    XCTAssertNil(info[@"PerJobMachServices"]); /// Wasn't closed, so it's not attached to the outer dict
+}
+
+- (void)testCRLFLineEndings {
+
+    NSString *crlf = [kFinder stringByReplacingOccurrencesOfString:@"\n" withString:@"\r\n"];
+    XCTAssertEqualObjects([LaunchctlParser parseOutput:crlf], [LaunchctlParser parseOutput:kFinder]);
+}
+
+@end
@@ -0,0 +1,117 @@
+//
+// --------------------------------------------------------------------------
+// OverlayDamageTrackerTests.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Tests for the per-frame coalescing in OverlayDamageTracker.swift
+///     OverlayDamageTracker.swift is a Helper source. It only depends on Foundation, so it's compiled straight into the test target.
+
+import XCTest
+
+final class OverlayDamageTrackerTests: XCTestCase {
+
+    private let size = CGSize(width: 32, height: 32)
+
+    func testNothingChangedGivesNoUpdate() {
+        var tracker = OverlayDamageTracker(capacity: 4)
+        XCTAssertEqual(tracker.takeUpdate().changedSlots, 0)
+    }
+
+    func testManyMovesBeforeAFrameGiveOneUpdate() {
+
+        /// Like a 1000 Hz mouse between two 60 Hz frames
+
+        var tracker = OverlayDamageTracker(capacity: 4)
+        tracker.setFrame(CGRect(origin: .zero, size: size), forSlot: 1)
+        tracker.setVisible(true, forSlot: 1)
+        _ = tracker.takeUpdate()
+
+        for i in 1...16 {
+            tracker.setOrigin(CGPoint(x: i, y: 2 * i), forSlot: 1)
+        }
+
+        let (changedSlots, shouldStop) = tracker.takeUpdate()
+        XCTAssertEqual(changedSlots, 1 << 1)
+        XCTAssertFalse(shouldStop)
+        XCTAssertEqual(tracker.slots[1].frame.origin, CGPoint(x: 16, y: 32)) /// Last move wins
+
+        XCTAssertEqual(tracker.takeUpdate().changedSlots, 0) /// Taken
+    }
+
+    func testChangesToSeveralSlotsAreReportedTogether() {
+
+        var tracker = OverlayDamageTracker(capacity: 4)
+        tracker.setVisible(true, forSlot: 0)
+        tracker.setVisible(true, forSlot: 3)
+        tracker.setOrigin(CGPoint(x: 5, y: 5), forSlot: 3)
+
+        XCTAssertEqual(tracker.takeUpdate().changedSlots, 1 << 0 | 1 << 3)
+    }
+
+    func testChangesThatCancelOutGiveNoUpdate() {
+
+        var tracker = OverlayDamageTracker(capacity: 4)
+        tracker.setFrame(CGRect(origin: .zero, size: size), forSlot: 2)
+        tracker.setVisible(true, forSlot: 2)
+        _ = tracker.takeUpdate()
+
+        /// Moved away and back, hidden and shown again, all before the frame
+        tracker.setOrigin(CGPoint(x: 100, y: 100), forSlot: 2)
+        tracker.setOrigin(.zero, forSlot: 2)
+        tracker.setVisible(false, forSlot: 2)
+        tracker.setVisible(true, forSlot: 2)
+
+        let (changedSlots, shouldStop) = tracker.takeUpdate()
+        XCTAssertEqual(changedSlots, 0)
+        XCTAssertFalse(shouldStop) /// Something was written, so this doesn't count as an idle frame
+    }
+
+    func testStopsAfterIdleFrames() {
+
+        var tracker = OverlayDamageTracker(capacity: 4, idleFramesBeforeStop: 5)
+        tracker.setVisible(true, forSlot: 0)
+        XCTAssertFalse(tracker.takeUpdate().shouldStop)
+
+        for _ in 1..<5 {
+            XCTAssertFalse(tracker.takeUpdate().shouldStop)
+        }
+        XCTAssertTrue(tracker.takeUpdate().shouldStop)
+    }
+
+    func testChangeResetsIdleCount() {
+
+        var tracker = OverlayDamageTracker(capacity: 4, idleFramesBeforeStop: 3)
+
+        _ = tracker.takeUpdate()
+        _ = tracker.takeUpdate()
+        tracker.setOrigin(CGPoint(x: 1, y: 1), forSlot: 0)
+        XCTAssertEqual(tracker.takeUpdate().changedSlots, 1 << 0)
+
+        XCTAssertFalse(tracker.takeUpdate().shouldStop)
+        XCTAssertFalse(tracker.takeUpdate().shouldStop)
+        XCTAssertTrue(tracker.takeUpdate().shouldStop)
+    }
+
+    func testPerformanceOfCoalescingMouseMoves() {
+
+        /// 10 s of a 1000 Hz mouse moving one sprite, with a frame every 8 moves (~120 Hz).
+
+        measure {
+            var tracker = OverlayDamageTracker(capacity: 4)
+            tracker.setFrame(CGRect(origin: .zero, size: size), forSlot: 0)
+            tracker.setVisible(true, forSlot: 0)
+            var nOfUpdates = 0
+            for i in 0..<10_000 {
+                tracker.setOrigin(CGPoint(x: Double(i % 1000), y: Double(i / 1000)), forSlot: 0)
+                if i % 8 == 7 && tracker.takeUpdate().changedSlots != 0 {
+                    nOfUpdates += 1
+                }
+            }
+            XCTAssertEqual(nOfUpdates, 10_000 / 8)
+        }
+    }
+}
@@ -0,0 +1,80 @@
+//
+// --------------------------------------------------------------------------
+// RevalidatingCacheTests.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Checks that a `RevalidatingCache` with an `invalidationNotification` refetches after the notification is posted.
+///     Darwin notifications are delivered to the posting process too, so posting from the test takes the same path as a post from the other process. (That's what happens to the helper's license cache when the mainApp changes the key.)
+
+import XCTest
+@testable import Mac_Mouse_Fix
+
+final class RevalidatingCacheTests: XCTestCase {
+
+    private final class FetchCounter {
+        private let lock = NSLock()
+        private var count: Int32 = 0
+        func increment() -> Int32 {
+            lock.lock(); defer { lock.unlock() }
+            count += 1
+            return count
+        }
+    }
+
+    private func makeCache(notification: String?, counter: FetchCounter) -> RevalidatingCache<Int32> {
+        
+        /// Each fetch returns the number of fetches so far
+        
+        return RevalidatingCache<Int32>(label: "test-cache", maxAge: 60*60, maxStaleAge: 60*60, minBackoff: 10, maxBackoff: 10, invalidationNotification: notification) { onComplete in
+            onComplete(counter.increment(), true)
+        }
+    }
+
+    private func getValue(_ cache: RevalidatingCache<Int32>) -> Int32 {
+        let done = DispatchSemaphore(value: 0)
+        var result: Int32 = -1
+        cache.get { value, _ in
+            result = value
+            done.signal()
+        }
+        XCTAssertEqual(done.wait(timeout: .now() + 5), .success)
+        return result
+    }
+
+    func testNotificationInvalidatesCache() {
+
+        let notification = "com.nuebling.mac-mouse-fix.test.\(UUID().uuidString)" /// Unique, so the test doesn't invalidate anything else
+        let cache = makeCache(notification: notification, counter: FetchCounter())
+
+        /// Fill the cache
+        XCTAssertEqual(getValue(cache), 1)
+        XCTAssertEqual(getValue(cache), 1) /// From cache
+
+        /// Post like the other process would
+        notify_post(notification)
+
+        /// Wait for refetch
+        ///     The notification is delivered asynchronously, so we keep asking until the cache gives us a new value.
+        let deadline = Date(timeIntervalSinceNow: 5)
+        var value = getValue(cache)
+        while value == 1 && Date() < deadline {
+            Thread.sleep(forTimeInterval: 0.01)
+            value = getValue(cache)
+        }
+        XCTAssertEqual(value, 2)
+    }
+
+    func testOtherNotificationsDontInvalidateCache() {
+
+        let cache = makeCache(notification: "com.nuebling.mac-mouse-fix.test.\(UUID().uuidString)", counter: FetchCounter())
+
+        XCTAssertEqual(getValue(cache), 1)
+        notify_post("com.nuebling.mac-mouse-fix.test.\(UUID().uuidString)")
+        Thread.sleep(forTimeInterval: 0.1)
+        XCTAssertEqual(getValue(cache), 1)
+    }
+}
@@ -0,0 +1,112 @@
+//
+// --------------------------------------------------------------------------
+// ScrollTickCarryTests.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Replays long series of scroll ticks through `MFScrollTickCarryApply()`, which is the step that Scroll.m's `heavyProcessing()` runs after the acceleration curve and fastScroll gave a fractional px distance for a tick.
+///     Without smoothing, the total distance that's sent should match the total distance that the curve asks for to within one px, no matter how many ticks there are. With smoothing, backlogged ticks shouldn't lose any px.
+///     ScrollTickCarry.m is a Helper source, but it's plain C, so it's compiled straight into the test target.
+
+#import <XCTest/XCTest.h>
+#import "ScrollTickCarry.h"
+
+@interface ScrollTickCarryTests : XCTestCase
+
+@end
+
+@implementation ScrollTickCarryTests
+
+static double pxForTick(double timeBetweenTicks, double fastScrollFactor) {
+    /// Stand-in for the acceleration curve. Grows with scroll speed and is fractional almost everywhere.
+    double speed = 1.0 / timeBetweenTicks; /// tick/s
+    return (2.0 + 0.37 * speed + 0.0011 * speed * speed) * fastScrollFactor;
+}
+
+- (void)testDirectScrollingErrorStaysBelowOnePixel {
+
+    MFScrollTickCarry carry = {0};
+    srand48(54);
+
+    double exact = 0.0;
+    double sent = 0.0;
+    double truncated = 0.0; /// What the old code sent
+
+    for (int i = 0; i < 10000; i++) {
+
+        double timeBetweenTicks = 0.015 + drand48() * (0.160 - 0.015); /// Between AccelerationEnd and consecutiveScrollTickIntervalMax
+        double fastScrollFactor = (i % 500 > 400) ? 1.0 + drand48() * 3.0 : 1.0; /// Occasional fast scroll bursts
+
+        double px = pxForTick(timeBetweenTicks, fastScrollFactor);
+
+        MFScrollTickCarryResult result = MFScrollTickCarryApply(&carry, px, false, (int64_t)(drand48() * 3)); /// Queued ticks don't matter without smoothing
+        XCTAssertFalse(result.isDeferred);
+        XCTAssertEqual(result.px, round(result.px)); /// Whole px
+
+        exact += px;
+        sent += result.px;
+        truncated += (double)(int64_t)pxForTick(timeBetweenTicks, 1.0) * fastScrollFactor;
+    }
+
+    XCTAssertLessThan(fabs(sent - exact), 1.0, @"exact: %f, sent: %f", exact, sent);
+    XCTAssertGreaterThan(fabs(truncated - exact), 1.0); /// Sanity check that the replay actually produces fractional px
+}
+
+- (void)testAnimatedBacklogIsSentWithLastTick {
+
+    /// Bursts of queued ticks, like after the `_scrollQueue` fell behind. Only the last tick of each burst should start an animation, and it should carry the whole burst.
+
+    MFScrollTickCarry carry = {0};
+    srand48(55);
+
+    double exact = 0.0;
+    double sent = 0.0;
+    int nOfAnimations = 0;
+
+    for (int burst = 0; burst < 1000; burst++) {
+
+        int64_t burstLength = 1 + (int64_t)(drand48() * 8);
+        double burstPx = 0.0;
+
+        for (int64_t queuedBehind = burstLength - 1; queuedBehind >= 0; queuedBehind--) {
+
+            double px = pxForTick(0.015 + drand48() * 0.1, 1.0);
+            exact += px;
+            burstPx += px;
+
+            MFScrollTickCarryResult result = MFScrollTickCarryApply(&carry, px, true, queuedBehind);
+
+            if (queuedBehind > 0) {
+                XCTAssertTrue(result.isDeferred);
+            } else {
+                XCTAssertFalse(result.isDeferred);
+                XCTAssertEqualWithAccuracy(result.px, burstPx, 1e-9); /// Not rounded, the animator does that
+                sent += result.px;
+                nOfAnimations += 1;
+            }
+        }
+    }
+
+    XCTAssertEqual(nOfAnimations, 1000);
+    XCTAssertEqualWithAccuracy(sent, exact, 1e-6);
+}
+
+- (void)testResetDropsBacklogAndRoundingError {
+
+    /// Scroll.m resets the carry on direction change, so px from the old direction don't leak into the new one.
+
+    MFScrollTickCarry carry = {0};
+
+    XCTAssertEqual(MFScrollTickCarryApply(&carry, 0.4, false, 0).px, 0.0);
+    MFScrollTickCarryReset(&carry);
+    XCTAssertEqual(MFScrollTickCarryApply(&carry, 0.4, false, 0).px, 0.0); /// Would be 1 with the 0.4 from before
+
+    XCTAssertTrue(MFScrollTickCarryApply(&carry, 10.0, true, 1).isDeferred);
+    MFScrollTickCarryReset(&carry);
+    XCTAssertEqual(MFScrollTickCarryApply(&carry, 3.0, true, 0).px, 3.0);
+}
+
+@end
@@ -0,0 +1,175 @@
+//
+// --------------------------------------------------------------------------
+// SharedStatusTests.m
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Stress tests for the seqlock and the single-producer / single-consumer ring in MFSharedStatus.m
+///     These run on a private region, so they don't interfere with a Helper that's running on the test machine.
+
+#import <XCTest/XCTest.h>
+#import "MFSharedStatus.h"
+#import <stdatomic.h>
+
+@interface SharedStatusTests : XCTestCase
+
+@end
+
+@implementation SharedStatusTests
+
+static void fillStatus(MFSharedStatus *status, uint32_t i) {
+
+    /// Every field is derived from `i`, so a reader can tell if it got a torn copy.
+
+    status->helperPid = 1;
+    status->helperBundleVersion = i;
+    status->helperIsLockedDown = (uint8_t)i;
+    status->addModeIsEnabled = (uint8_t)(i >> 8);
+    status->keyCaptureModeIsEnabled = (uint8_t)(i >> 16);
+    status->activeDeviceButtonCount = ~i;
+    memset(status->activeDeviceName, 'a' + (i % 26), kMFSharedStatusDeviceNameCapacity - 1);
+    status->activeDeviceName[kMFSharedStatusDeviceNameCapacity - 1] = '\0';
+    status->keyboardModifierFlags = (uint64_t)i * 0x9E3779B97F4A7C15;
+    status->buttonModifierCount = i * 3;
+    status->buttonModifierSignature = (uint64_t)i << 32 | i;
+}
+
+static BOOL statusIsConsistent(const MFSharedStatus *status) {
+
+    uint32_t i = status->helperBundleVersion;
+
+    MFSharedStatus expected = {0};
+    fillStatus(&expected, i);
+
+    return expected.helperPid == status->helperPid
+        && expected.helperIsLockedDown == status->helperIsLockedDown
+        && expected.addModeIsEnabled == status->addModeIsEnabled
+        && expected.keyCaptureModeIsEnabled == status->keyCaptureModeIsEnabled
+        && expected.activeDeviceButtonCount == status->activeDeviceButtonCount
+        && strcmp(expected.activeDeviceName, status->activeDeviceName) == 0
+        && expected.keyboardModifierFlags == status->keyboardModifierFlags
+        && expected.buttonModifierCount == status->buttonModifierCount
+        && expected.buttonModifierSignature == status->buttonModifierSignature;
+}
+
+- (void)testSeqlockReadersNeverSeeTornStatus {
+
+    MFSharedStatusRegion *region = MFSharedStatusRegionCreatePrivate();
+    MFSharedStatusRegionUpdate(region, ^(MFSharedStatus *status) { fillStatus(status, 0); });
+
+    const uint32_t nOfWrites = 200000;
+    const int nOfReaders = 3;
+
+    __block _Atomic(bool) writerIsDone = false;
+    __block _Atomic(uint64_t) nOfReads = 0;
+    __block _Atomic(uint64_t) nOfTornReads = 0;
+    __block _Atomic(uint64_t) nOfBackwardsReads = 0;
+
+    dispatch_group_t group = dispatch_group_create();
+
+    /// Writer
+    dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        for (uint32_t i = 1; i <= nOfWrites; i++) {
+            MFSharedStatusRegionUpdate(region, ^(MFSharedStatus *status) { fillStatus(status, i); });
+        }
+        atomic_store(&writerIsDone, true);
+    });
+
+    /// Readers
+    for (int r = 0; r < nOfReaders; r++) {
+        dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            uint32_t last = 0;
+            while (!atomic_load(&writerIsDone)) {
+                MFSharedStatus status;
+                if (!MFSharedStatusRegionRead(region, &status)) continue; /// Gave up because the writer was too busy. That's allowed.
+                atomic_fetch_add(&nOfReads, 1);
+                if (!statusIsConsistent(&status))           atomic_fetch_add(&nOfTornReads, 1);
+                if (status.helperBundleVersion < last)      atomic_fetch_add(&nOfBackwardsReads, 1);
+                last = status.helperBundleVersion;
+            }
+        });
+    }
+
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    MFSharedStatus final;
+    XCTAssertTrue(MFSharedStatusRegionRead(region, &final));
+    XCTAssertEqual(final.helperBundleVersion, nOfWrites);
+
+    XCTAssertGreaterThan(atomic_load(&nOfReads), 0);
+    XCTAssertEqual(atomic_load(&nOfTornReads), 0);
+    XCTAssertEqual(atomic_load(&nOfBackwardsReads), 0);
+
+    MFSharedStatusRegionFree(region);
+}
+
+- (void)testRingDeliversEntriesInOrderUnderContention {
+
+    MFSharedStatusRegion *region = MFSharedStatusRegionCreatePrivate();
+
+    const uint32_t nOfEntries = 100000;
+
+    __block uint32_t nOfFullPushes = 0;
+    __block uint32_t nOfMismatches = 0;
+    __block uint32_t nOfReceived = 0;
+
+    dispatch_group_t group = dispatch_group_create();
+
+    /// Producer
+    ///     Entries have different lengths, so a consumer that reads a slot before it's completely written would notice.
+    dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        for (uint32_t i = 0; i < nOfEntries; i++) {
+            NSMutableData *entry = [NSMutableData dataWithLength:sizeof(i) + (i % 300)];
+            memcpy(entry.mutableBytes, &i, sizeof(i));
+            memset((uint8_t *)entry.mutableBytes + sizeof(i), (uint8_t)i, i % 300);
+            while (!MFSharedStatusRegionPush(region, entry)) {
+                nOfFullPushes += 1;
+            }
+        }
+    });
+
+    /// Consumer
+    dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        uint32_t expected = 0;
+        while (expected < nOfEntries) {
+            NSData *entry = MFSharedStatusRegionPop(region);
+            if (entry == nil) continue;
+
+            uint32_t i;
+            memcpy(&i, entry.bytes, sizeof(i));
+            BOOL ok = i == expected && entry.length == sizeof(i) + (i % 300);
+            for (NSUInteger b = sizeof(i); ok && b < entry.length; b++) {
+                ok = ((const uint8_t *)entry.bytes)[b] == (uint8_t)i;
+            }
+            if (!ok) nOfMismatches += 1;
+
+            expected += 1;
+            nOfReceived += 1;
+        }
+    });
+
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 60 * NSEC_PER_SEC)), 0, @"Producer or consumer got stuck");
+
+    XCTAssertEqual(nOfReceived, nOfEntries);
+    XCTAssertEqual(nOfMismatches, 0);
+    XCTAssertNil(MFSharedStatusRegionPop(region));
+
+    NSLog(@"Ring was full on %u push attempts", nOfFullPushes);
+
+    MFSharedStatusRegionFree(region);
+}
+
+- (void)testRingRejectsOversizedEntries {
+
+    MFSharedStatusRegion *region = MFSharedStatusRegionCreatePrivate();
+
+    XCTAssertFalse(MFSharedStatusRegionPush(region, [NSMutableData dataWithLength:4096]));
+    XCTAssertNil(MFSharedStatusRegionPop(region));
+
+    MFSharedStatusRegionFree(region);
+}
+
+@end
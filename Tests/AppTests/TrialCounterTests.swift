@@ -0,0 +1,103 @@
+//
+// --------------------------------------------------------------------------
+// TrialCounterTests.swift
+// Created for Mac Mouse Fix (https://github.com/noah-nuebling/mac-mouse-fix)
+// Created by Noah Nuebling in 2026
+// Licensed under the MMF License (https://github.com/noah-nuebling/mac-mouse-fix/blob/master/License)
+// --------------------------------------------------------------------------
+//
+
+/// Runs the trial day counting against an in-memory storage instead of the keychain.
+
+import XCTest
+@testable import Mac_Mouse_Fix
+
+final class TrialCounterTests: XCTestCase {
+
+    private final class CountingStorage: TrialCounterStorage {
+        
+        /// In-memory storage that counts writes. (Each write to the real storage is a keychain round trip.)
+        
+        private var _daysOfUse = 0
+        private var _lastUseDate: Date? = nil
+        var nOfWrites = 0
+        var daysOfUse: Int {
+            get { _daysOfUse }
+            set { _daysOfUse = newValue; nOfWrites += 1 }
+        }
+        var lastUseDate: Date? {
+            get { _lastUseDate }
+            set { _lastUseDate = newValue; nOfWrites += 1 }
+        }
+    }
+
+    private func date(_ day: Int, _ hour: Int, _ minute: Int = 0) -> Date {
+        var components = DateComponents()
+        components.year = 2026
+        components.month = 3
+        components.day = day
+        components.hour = hour
+        components.minute = minute
+        return Calendar.current.date(from: components)!
+    }
+
+    func testCountsEachDayOnce() {
+
+        let storage = CountingStorage()
+
+        XCTAssertTrue(TrialCounter.recordUse(at: date(1, 9), in: storage))
+        XCTAssertFalse(TrialCounter.recordUse(at: date(1, 9, 1), in: storage))
+        XCTAssertFalse(TrialCounter.recordUse(at: date(1, 23, 59), in: storage))
+
+        XCTAssertEqual(storage.daysOfUse, 1)
+        XCTAssertEqual(storage.nOfWrites, 2) /// lastUseDate + daysOfUse, once
+
+        XCTAssertTrue(TrialCounter.recordUse(at: date(2, 0, 0), in: storage))
+        XCTAssertEqual(storage.daysOfUse, 2)
+    }
+
+    func testSkippedDaysDontCount() {
+
+        let storage = CountingStorage()
+
+        _ = TrialCounter.recordUse(at: date(1, 12), in: storage)
+        _ = TrialCounter.recordUse(at: date(5, 12), in: storage)
+        _ = TrialCounter.recordUse(at: date(6, 12), in: storage)
+
+        XCTAssertEqual(storage.daysOfUse, 3)
+    }
+
+    func testReplayOfAMonthOfUse() {
+
+        /// Many uses per day at random times, some days without any use
+
+        var rng = SystemRandomNumberGenerator()
+        let storage = CountingStorage()
+        var expectedDays = 0
+
+        for day in 1...30 {
+            if day % 7 == 0 { continue } /// Day off
+            expectedDays += 1
+            let hours = (0..<20).map { _ in Int.random(in: 0...23, using: &rng) }.sorted()
+            for hour in hours {
+                _ = TrialCounter.recordUse(at: date(day, hour, Int.random(in: 0...59, using: &rng)), in: storage)
+            }
+        }
+
+        XCTAssertEqual(storage.daysOfUse, expectedDays)
+        XCTAssertEqual(storage.nOfWrites, 2 * expectedDays)
+    }
+
+    func testContinuesFromStoredCount() {
+
+        /// E.g. after the helper restarts, the count continues from what's stored
+
+        let storage = CountingStorage()
+        storage.daysOfUse = 13
+        storage.lastUseDate = date(10, 18)
+
+        XCTAssertFalse(TrialCounter.recordUse(at: date(10, 20), in: storage))
+        XCTAssertTrue(TrialCounter.recordUse(at: date(11, 8), in: storage))
+        XCTAssertEqual(storage.daysOfUse, 14)
+    }
+}